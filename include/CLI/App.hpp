@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <deque>
+#include <fstream>
 #include <functional>
 #include <iostream>
 #include <memory>
@@ -19,10 +20,15 @@
 // CLI Library includes
 #include "CLI/Error.hpp"
 #include "CLI/Ini.hpp"
+#include "CLI/Lazy.hpp"
 #include "CLI/Macros.hpp"
+#include "CLI/NameIndex.hpp"
 #include "CLI/Option.hpp"
+#include "CLI/ParseResult.hpp"
+#include "CLI/ParseStatus.hpp"
 #include "CLI/Split.hpp"
 #include "CLI/StringTools.hpp"
+#include "CLI/TokenStream.hpp"
 #include "CLI/TypeTools.hpp"
 
 namespace CLI {
@@ -37,7 +43,6 @@ namespace CLI {
 #endif
 
 namespace detail {
-enum class Classifer { NONE, POSITIONAL_MARK, SHORT, LONG, SUBCOMMAND };
 struct AppFriend;
 } // namespace detail
 
@@ -47,6 +52,7 @@ std::string help(const App *app, const Error &e);
 } // namespace FailureMessage
 
 class App;
+class PushParser;
 
 using App_p = std::unique_ptr<App>;
 
@@ -56,7 +62,9 @@ using App_p = std::unique_ptr<App>;
  * program, so that the options can be evaluated and the help option doesn't accidentally run your program. */
 class App {
     friend Option;
+    friend PushParser;
     friend detail::AppFriend;
+    friend ParseStatus try_parse_parallel(App &app, int argc, const char *const *argv, unsigned num_threads);
 
   protected:
     // This library follows the Google style guide for member names ending in underscores
@@ -79,6 +87,12 @@ class App {
     ///  If true, return immediately on an unrecognised option (implies allow_extras) INHERITABLE
     bool prefix_command_{false};
 
+    /// If true, `@path` arguments are replaced by the arguments in that file
+    bool response_files_{false};
+
+    /// If true, a long option can be given by any unique prefix of its name. INHERITABLE
+    bool allow_abbreviations_{false};
+
     /// This is a function that runs when complete. Great for subcommands. Can throw.
     std::function<void()> callback_;
 
@@ -92,6 +106,27 @@ class App {
     /// The list of options, stored locally
     std::vector<Option_p> options_;
 
+    /// Lookup table for the long names of options_ (kept in sync by add_option, remove_option and ignore_case)
+    detail::NameIndex<Option *> lnames_index_;
+
+    /// Lookup table for the short names of options_
+    detail::CharIndex<Option *> snames_index_;
+
+    /// Lookup table for the positional names of options_
+    detail::NameIndex<Option *> pnames_index_;
+
+    /// Prefixes of the long names of options_, built by `_validate` if abbreviations are allowed
+    detail::PrefixTrie<Option *> lnames_trie_;
+
+    /// Groups of options of which at most one can be given
+    std::vector<std::vector<Option *>> exclusive_groups_;
+
+    /// The ids of the required options. Built by _validate.
+    detail::OptionBits required_bits_;
+
+    /// The ids of each of exclusive_groups_. Built by _validate.
+    std::vector<detail::OptionBits> exclusive_bits_;
+
     ///@}
     /// @name Help
     ///@{
@@ -111,6 +146,13 @@ class App {
 
     using missing_t = std::vector<std::pair<detail::Classifer, std::string>>;
 
+    /// Where a parse is up to: the Apps entered in order (the last one gets the next argument), and whether a `--` was
+    /// seen since entering it
+    struct ParseCursor {
+        std::vector<App *> apps;
+        bool positional_only{false};
+    };
+
     /// Pair of classifier, string for missing options. (extra detail is removed on returning from parse)
     ///
     /// This is faster and cleaner than storing just a list of strings and reparsing. This may contain the -- separator.
@@ -122,6 +164,18 @@ class App {
     /// This is a list of the subcommands collected, in order
     std::vector<App *> parsed_subcommands_;
 
+    /// How far positionals_ has been filled in the current parse
+    detail::PositionalCursor positional_cursor_;
+
+    /// The ids of the options that were given a value
+    detail::OptionBits given_;
+
+    /// Why the last parse failed, kept by the top App (see `_status`)
+    ParseStatus status_;
+
+    /// Storage for the text of the results of all the options of this App, released by `reset`
+    detail::ResultArena results_arena_;
+
     ///@}
     /// @name Subcommands
     ///@{
@@ -129,6 +183,21 @@ class App {
     /// Storage for subcommand list
     std::vector<App_p> subcommands_;
 
+    /// Lookup table for the names of subcommands_ (kept in sync by add_subcommand, set_name and ignore_case)
+    detail::NameIndex<App *> subcommand_index_;
+
+    /// Lookup table for the subcommands of this App and all its parents, nearest first. Built by _validate.
+    detail::NameIndex<App *> subcommand_resolver_;
+
+    /// The positional options, in the order they are filled. Built by _validate.
+    std::vector<Option *> positionals_;
+
+    /// The ids of the options that can be set from the environment. Built by _validate.
+    detail::OptionBits env_bits_;
+
+    /// If true, the tables built by _validate are kept for every parse and the App can no longer be changed
+    bool frozen_{false};
+
     /// If true, the program name is not case sensitive INHERITABLE
     bool ignore_case_{false};
 
@@ -183,6 +252,7 @@ class App {
             prefix_command_ = parent_->prefix_command_;
             ignore_case_ = parent_->ignore_case_;
             fallthrough_ = parent_->fallthrough_;
+            allow_abbreviations_ = parent_->allow_abbreviations_;
             group_ = parent_->group_;
             footer_ = parent_->footer_;
             require_subcommand_max_ = parent_->require_subcommand_max_;
@@ -214,12 +284,18 @@ class App {
 
     /// Set a name for the app (empty will use parser to set the name)
     App *set_name(std::string name = "") {
+        _check_not_frozen();
+        if(parent_ != nullptr)
+            parent_->subcommand_index_.remove(name_, this);
         name_ = name;
+        if(parent_ != nullptr)
+            parent_->subcommand_index_.add(name_, ignore_case_, this);
         return this;
     }
 
     /// Remove the error when extras are left over on the command line.
     App *allow_extras(bool allow = true) {
+        _check_not_frozen();
         allow_extras_ = allow;
         return this;
     }
@@ -227,6 +303,7 @@ class App {
     /// Remove the error when extras are left over on the command line.
     /// Will also call App::allow_extras().
     App *allow_ini_extras(bool allow = true) {
+        _check_not_frozen();
         allow_extras(allow);
         allow_ini_extras_ = allow;
         return this;
@@ -234,18 +311,34 @@ class App {
 
     /// Do not parse anything after the first unrecognised option and return
     App *prefix_command(bool allow = true) {
+        _check_not_frozen();
         prefix_command_ = allow;
         return this;
     }
 
+    /// Replace each `@path` argument with the arguments in that file (split like a shell, without escapes)
+    App *response_files(bool allow = true) {
+        _check_not_frozen();
+        response_files_ = allow;
+        return this;
+    }
+
+    /// Accept any unique prefix of a long option name (`--verb` for `--verbose`). Subcommands inherit value.
+    App *allow_abbreviations(bool allow = true) {
+        _check_not_frozen();
+        allow_abbreviations_ = allow;
+        return this;
+    }
+
     /// Ignore case. Subcommand inherit value.
     App *ignore_case(bool value = true) {
+        _check_not_frozen();
         ignore_case_ = value;
         if(parent_ != nullptr) {
-            for(const auto &subc : parent_->subcommands_) {
-                if(subc.get() != this && (this->check_name(subc->name_) || subc->check_name(this->name_)))
-                    throw OptionAlreadyAdded(subc->name_);
-            }
+            parent_->subcommand_index_.remove(name_, this);
+            parent_->subcommand_index_.add(name_, ignore_case_, this);
+            if(App *subc = parent_->subcommand_index_.conflict(name_, ignore_case_, this))
+                throw OptionAlreadyAdded(subc->name_);
         }
         return this;
     }
@@ -253,6 +346,9 @@ class App {
     /// Check to see if this subcommand was parsed, true only if received on command line.
     bool parsed() const { return parsed_; }
 
+    /// Check to see if the parse tables of this App have been frozen
+    bool get_frozen() const { return frozen_; }
+
     /// Get the OptionDefault object, to set option defaults
     OptionDefaults *option_defaults() { return &option_defaults_; }
 
@@ -275,18 +371,26 @@ class App {
     ///     program.add_option("filename", filename, "description of filename");
     ///
     Option *add_option(std::string name, callback_t callback, std::string description = "", bool defaulted = false) {
-        Option myopt{name, description, callback, defaulted, this};
+        view_callback_t fun = [callback](const ResultsView &res) { return callback(res.strs()); };
+        return add_option_view(name, fun, description, defaulted);
+    }
 
-        if(std::find_if(std::begin(options_), std::end(options_), [&myopt](const Option_p &v) {
-               return *v == myopt;
-           }) == std::end(options_)) {
-            options_.emplace_back();
-            Option_p &option = options_.back();
-            option.reset(new Option(name, description, callback, defaulted, this));
-            option_defaults_.copy_to(option.get());
-            return option.get();
-        } else
-            throw OptionAlreadyAdded(myopt.get_name());
+    /// Add an option with a callback that reads the results in place, without copying them into a `results_t`
+    Option *
+    add_option_view(std::string name, view_callback_t callback, std::string description = "", bool defaulted = false) {
+        _check_not_frozen();
+        Option_p option{new Option(name, description, callback, defaulted, this)};
+        option->arena_ = &results_arena_;
+
+        if(_find_conflict(option.get()) != nullptr)
+            throw OptionAlreadyAdded(option->get_name());
+
+        option->id_ = options_.size();
+        options_.push_back(std::move(option));
+        Option *opt = options_.back().get();
+        _index_option(opt);
+        option_defaults_.copy_to(opt);
+        return opt;
     }
 
     /// Add option for non-vectors (duplicate copy needed without defaulted to avoid `iostream << value`)
@@ -295,13 +399,12 @@ class App {
                        T &variable, ///< The variable to set
                        std::string description = "") {
 
-        std::string simple_name = CLI::detail::split(name, ',').at(0);
-        CLI::callback_t fun = [&variable, simple_name](CLI::results_t res) {
-            return detail::lexical_cast(res[0], variable);
+        Option *opt = add_option_view(name, CLI::view_callback_t(), description, false);
+        opt->callback_ = [&variable, opt](const CLI::ResultsView &res) {
+            return detail::lexical_cast(res[0], variable) && opt->_check_values(&variable, 1);
         };
-
-        Option *opt = add_option(name, fun, description, false);
         opt->set_custom_option(detail::type_name<T>());
+        opt->value_type_ = detail::type_tag<T>();
         return opt;
     }
 
@@ -312,13 +415,12 @@ class App {
                        std::string description,
                        bool defaulted) {
 
-        std::string simple_name = CLI::detail::split(name, ',').at(0);
-        CLI::callback_t fun = [&variable, simple_name](CLI::results_t res) {
-            return detail::lexical_cast(res[0], variable);
+        Option *opt = add_option_view(name, CLI::view_callback_t(), description, defaulted);
+        opt->callback_ = [&variable, opt](const CLI::ResultsView &res) {
+            return detail::lexical_cast(res[0], variable) && opt->_check_values(&variable, 1);
         };
-
-        Option *opt = add_option(name, fun, description, defaulted);
         opt->set_custom_option(detail::type_name<T>());
+        opt->value_type_ = detail::type_tag<T>();
         if(defaulted) {
             std::stringstream out;
             out << variable;
@@ -333,18 +435,17 @@ class App {
                        std::vector<T> &variable, ///< The variable vector to set
                        std::string description = "") {
 
-        CLI::callback_t fun = [&variable](CLI::results_t res) {
-            bool retval = true;
-            variable.clear();
-            for(const auto &a : res) {
-                variable.emplace_back();
-                retval &= detail::lexical_cast(a, variable.back());
+        Option *opt = add_option_view(name, CLI::view_callback_t(), description, false);
+        opt->callback_ = [&variable, opt](const CLI::ResultsView &res) {
+            std::size_t converted = detail::lexical_cast_all(res, variable);
+            if(converted != res.size()) {
+                res.fail_at(converted);
+                return false;
             }
-            return (!variable.empty()) && retval;
+            return !variable.empty() && opt->_check_values(variable.data(), variable.size());
         };
-
-        Option *opt = add_option(name, fun, description, false);
         opt->set_custom_option(detail::type_name<T>(), -1);
+        opt->value_type_ = detail::type_tag<T>();
         return opt;
     }
 
@@ -355,23 +456,62 @@ class App {
                        std::string description,
                        bool defaulted) {
 
-        CLI::callback_t fun = [&variable](CLI::results_t res) {
-            bool retval = true;
-            variable.clear();
-            for(const auto &a : res) {
-                variable.emplace_back();
-                retval &= detail::lexical_cast(a, variable.back());
+        Option *opt = add_option_view(name, CLI::view_callback_t(), description, defaulted);
+        opt->callback_ = [&variable, opt](const CLI::ResultsView &res) {
+            std::size_t converted = detail::lexical_cast_all(res, variable);
+            if(converted != res.size()) {
+                res.fail_at(converted);
+                return false;
             }
-            return (!variable.empty()) && retval;
+            return !variable.empty() && opt->_check_values(variable.data(), variable.size());
         };
-
-        Option *opt = add_option(name, fun, description, defaulted);
         opt->set_custom_option(detail::type_name<T>(), -1);
+        opt->value_type_ = detail::type_tag<T>();
         if(defaulted)
             opt->set_default_str("[" + detail::join(variable) + "]");
         return opt;
     }
 
+    /// Add a lazy option for non-vectors: the value is only converted when it is first read
+    template <typename T>
+    Option *add_option(std::string name,
+                       Lazy<T> &variable, ///< The variable to set when read
+                       std::string description = "") {
+
+        Option *opt = add_option_view(name, CLI::view_callback_t(), description, false);
+        opt->callback_ = [&variable, opt](const CLI::ResultsView &res) {
+            return detail::lexical_cast(res[0], variable.value_) && opt->_check_values(&variable.value_, 1);
+        };
+        opt->set_custom_option(detail::type_name<T>());
+        opt->value_type_ = detail::type_tag<T>();
+        opt->lazy();
+        variable.option_ = opt;
+        return opt;
+    }
+
+    /// Add a lazy option for vectors: the values are only converted when they are first read
+    template <typename T>
+    Option *add_option(std::string name,
+                       Lazy<std::vector<T>> &variable, ///< The variable vector to set when read
+                       std::string description = "") {
+
+        Option *opt = add_option_view(name, CLI::view_callback_t(), description, false);
+        opt->callback_ = [&variable, opt](const CLI::ResultsView &res) {
+            std::vector<T> &values = variable.value_;
+            std::size_t converted = detail::lexical_cast_all(res, values);
+            if(converted != res.size()) {
+                res.fail_at(converted);
+                return false;
+            }
+            return !values.empty() && opt->_check_values(values.data(), values.size());
+        };
+        opt->set_custom_option(detail::type_name<T>(), -1);
+        opt->value_type_ = detail::type_tag<T>();
+        opt->lazy();
+        variable.option_ = opt;
+        return opt;
+    }
+
     /// Set a help flag, replaced the existing one if present
     Option *set_help_flag(std::string name = "", std::string description = "") {
         if(help_ptr_ != nullptr) {
@@ -474,12 +614,9 @@ class App {
                     std::set<T> options, ///< The set of possibilities
                     std::string description = "") {
 
-        std::string simple_name = CLI::detail::split(name, ',').at(0);
-        CLI::callback_t fun = [&member, options, simple_name](CLI::results_t res) {
-            bool retval = detail::lexical_cast(res[0], member);
-            if(!retval)
-                throw ConversionError(res[0], simple_name);
-            return std::find(std::begin(options), std::end(options), member) != std::end(options);
+        CLI::callback_t fun = [&member, options](CLI::results_t res) {
+            return detail::lexical_cast(res[0], member) &&
+                   std::find(std::begin(options), std::end(options), member) != std::end(options);
         };
 
         Option *opt = add_option(name, fun, description, false);
@@ -497,12 +634,9 @@ class App {
                     std::string description,
                     bool defaulted) {
 
-        std::string simple_name = CLI::detail::split(name, ',').at(0);
-        CLI::callback_t fun = [&member, options, simple_name](CLI::results_t res) {
-            bool retval = detail::lexical_cast(res[0], member);
-            if(!retval)
-                throw ConversionError(res[0], simple_name);
-            return std::find(std::begin(options), std::end(options), member) != std::end(options);
+        CLI::callback_t fun = [&member, options](CLI::results_t res) {
+            return detail::lexical_cast(res[0], member) &&
+                   std::find(std::begin(options), std::end(options), member) != std::end(options);
         };
 
         Option *opt = add_option(name, fun, description, defaulted);
@@ -523,18 +657,15 @@ class App {
                                 std::set<std::string> options, ///< The set of possibilities
                                 std::string description = "") {
 
-        std::string simple_name = CLI::detail::split(name, ',').at(0);
-        CLI::callback_t fun = [&member, options, simple_name](CLI::results_t res) {
+        CLI::callback_t fun = [&member, options](CLI::results_t res) {
             member = detail::to_lower(res[0]);
             auto iter = std::find_if(std::begin(options), std::end(options), [&member](std::string val) {
                 return detail::to_lower(val) == member;
             });
             if(iter == std::end(options))
-                throw ConversionError(member, simple_name);
-            else {
-                member = *iter;
-                return true;
-            }
+                return false;
+            member = *iter;
+            return true;
         };
 
         Option *opt = add_option(name, fun, description, false);
@@ -552,18 +683,15 @@ class App {
                                 std::string description,
                                 bool defaulted) {
 
-        std::string simple_name = CLI::detail::split(name, ',').at(0);
-        CLI::callback_t fun = [&member, options, simple_name](CLI::results_t res) {
+        CLI::callback_t fun = [&member, options](CLI::results_t res) {
             member = detail::to_lower(res[0]);
             auto iter = std::find_if(std::begin(options), std::end(options), [&member](std::string val) {
                 return detail::to_lower(val) == member;
             });
             if(iter == std::end(options))
-                throw ConversionError(member, simple_name);
-            else {
-                member = *iter;
-                return true;
-            }
+                return false;
+            member = *iter;
+            return true;
         };
 
         Option *opt = add_option(name, fun, description, defaulted);
@@ -628,26 +756,54 @@ class App {
 
     /// Removes an option from the App. Takes an option pointer. Returns true if found and removed.
     bool remove_option(Option *opt) {
+        _check_not_frozen();
         auto iterator =
             std::find_if(std::begin(options_), std::end(options_), [opt](const Option_p &v) { return v.get() == opt; });
         if(iterator != std::end(options_)) {
-            options_.erase(iterator);
+            _unindex_option(opt);
+            for(std::vector<Option *> &group : exclusive_groups_)
+                group.erase(std::remove(std::begin(group), std::end(group), opt), std::end(group));
+            for(const Option_p &other : options_) {
+                other->requires_.erase(opt);
+                other->excludes_.erase(opt);
+            }
+            iterator = options_.erase(iterator);
+
+            // Keep the ids dense, and mark the given options again under their new ids (the other tables of ids are
+            // built again by _validate before the next parse)
+            for(; iterator != std::end(options_); ++iterator)
+                (*iterator)->id_--;
+            given_.clear();
+            for(const Option_p &other : options_)
+                if(other->count() > 0)
+                    given_.set(other->id_);
             return true;
         }
         return false;
     }
 
+    /// Only allow one of a group of options of this App to be given (like `excludes` between every pair)
+    App *mutually_exclusive(std::vector<Option *> options) {
+        _check_not_frozen();
+        for(const Option *opt : options)
+            if(opt->parent_ != this)
+                throw IncorrectConstruction::MissingOption(opt->get_name());
+        exclusive_groups_.push_back(std::move(options));
+        return this;
+    }
+
     ///@}
     /// @name Subcommmands
     ///@{
 
     /// Add a subcommand. Inherits INHERITABLE and OptionDefaults, and help flag
     App *add_subcommand(std::string name, std::string description = "") {
-        subcommands_.emplace_back(new App(description, name, this));
-        for(const auto &subc : subcommands_)
-            if(subc.get() != subcommands_.back().get())
-                if(subc->check_name(subcommands_.back()->name_) || subcommands_.back()->check_name(subc->name_))
-                    throw OptionAlreadyAdded(subc->name_);
+        _check_not_frozen();
+        App_p subcom{new App(description, name, this)};
+        if(App *subc = subcommand_index_.conflict(subcom->name_, subcom->ignore_case_, subcom.get()))
+            throw OptionAlreadyAdded(subc->name_);
+        subcommand_index_.add(subcom->name_, subcom->ignore_case_, subcom.get());
+        subcommands_.push_back(std::move(subcom));
         return subcommands_.back().get();
     }
 
@@ -661,10 +817,10 @@ class App {
 
     /// Check to see if a subcommand is part of this command (text version)
     App *get_subcommand(std::string subcom) const {
-        for(const App_p &subcomptr : subcommands_)
-            if(subcomptr->check_name(subcom))
-                return subcomptr.get();
-        throw OptionNotFound(subcom);
+        App *subcomptr = subcommand_index_.find(subcom);
+        if(subcomptr == nullptr)
+            throw OptionNotFound(subcom);
+        return subcomptr;
     }
 
     /// Changes the group membership
@@ -675,6 +831,7 @@ class App {
 
     /// The argumentless form of require subcommand requires 1 or more subcommands
     App *require_subcommand() {
+        _check_not_frozen();
         require_subcommand_min_ = 1;
         require_subcommand_max_ = 0;
         return this;
@@ -684,6 +841,7 @@ class App {
     /// The number required can be given. Negative values indicate maximum
     /// number allowed (0 for any number). Max number inheritable.
     App *require_subcommand(int value) {
+        _check_not_frozen();
         if(value < 0) {
             require_subcommand_min_ = 0;
             require_subcommand_max_ = static_cast<size_t>(-value);
@@ -697,6 +855,7 @@ class App {
     /// Explicitly control the number of subcommands required. Setting 0
     /// for the max means unlimited number allowed. Max number inheritable.
     App *require_subcommand(size_t min, size_t max) {
+        _check_not_frozen();
         require_subcommand_min_ = min;
         require_subcommand_max_ = max;
         return this;
@@ -705,6 +864,7 @@ class App {
     /// Stop subcommand fallthrough, so that parent commands cannot collect commands after subcommand.
     /// Default from parent, usually set on parent.
     App *fallthrough(bool value = true) {
+        _check_not_frozen();
         fallthrough_ = value;
         return this;
     }
@@ -726,25 +886,79 @@ class App {
     /// @name Parsing
     ///@{
 
+    /// Check the App and all its subcommands and build their parse tables once, instead of on every parse.
+    ///
+    /// Use this when one App parses many command lines. Options and subcommands can no longer be added, removed or
+    /// renamed afterwards, so set them up completely first.
+    App *freeze() {
+        if(!frozen_) {
+            _validate();
+            _freeze();
+        }
+        return this;
+    }
+
     /// Parses the command line - throws errors
     /// This must be called after the options are in but before the rest of the program.
-    void parse(int argc, char **argv) {
-        // If the name is not set, read from command line
-        if(name_.empty())
-            name_ = argv[0];
+    ///
+    /// The arguments are read in place; a copy is only made when a value is stored.
+    void parse(int argc, const char *const *argv) { try_parse(argc, argv).raise(); }
 
-        std::vector<std::string> args;
-        for(int i = argc - 1; i > 0; i--)
-            args.emplace_back(argv[i]);
-        parse(args);
+    /// Parses the command line - throws errors (mutable argv, as passed to main)
+    void parse(int argc, char **argv) { parse(argc, const_cast<const char *const *>(argv)); }
+
+    /// Compatibility version of parse. Expects a reversed vector.
+    /// Changes the vector to the remaining options (empty once all the arguments have been parsed).
+    void parse(std::vector<std::string> &args) { try_parse(args).raise(); }
+
+    /// Parses the command line like `parse`, but returns the error instead of throwing it (the message is only made
+    /// if it is asked for). Exceptions thrown by callbacks are not caught.
+    ParseStatus try_parse(int argc, const char *const *argv) {
+        detail::TokenStream tokens{argc > 1 ? static_cast<size_t>(argc - 1) : 0, argv + 1};
+        return _try_parse(tokens, argv[0]);
     }
 
-    /// The real work is done here. Expects a reversed vector.
-    /// Changes the vector to the remaining options.
-    void parse(std::vector<std::string> &args) {
-        _validate();
-        _parse(args);
-        run_callback();
+    /// Parses the command line without throwing (mutable argv, as passed to main)
+    ParseStatus try_parse(int argc, char **argv) { return try_parse(argc, const_cast<const char *const *>(argv)); }
+
+    /// Compatibility version of try_parse. Expects a reversed vector, which is changed to the remaining options.
+    ParseStatus try_parse(std::vector<std::string> &args) {
+        detail::TokenStream tokens{args};
+        _parse_tokens(tokens);
+
+        // The tokens point into the vector, so the remaining options are copied out before it is changed
+        std::vector<std::string> remaining = tokens.remaining_reversed();
+        args = std::move(remaining);
+        return _status(nullptr);
+    }
+
+    /// Parse without changing the App, so that many threads can parse with one App. The App must be frozen.
+    ///
+    /// The arguments are given in order, without the program name. Everything found goes in the returned result, and
+    /// no callbacks are run. Errors are thrown as usual.
+    ParseResult parse_result(const std::vector<string_view> &args) const {
+        ParseResult result = try_parse_result(args);
+        result.get_status().raise();
+        return result;
+    }
+
+    /// Parse the command line without changing the App (see above); argv[0] is skipped.
+    ParseResult parse_result(int argc, const char *const *argv) const {
+        ParseResult result = try_parse_result(argc, argv);
+        result.get_status().raise();
+        return result;
+    }
+
+    /// Like `parse_result`, but a parse error is returned in `ParseResult::get_status` instead of thrown
+    ParseResult try_parse_result(const std::vector<string_view> &args) const {
+        detail::TokenStream tokens{args.data(), args.size()};
+        return _parse_result(tokens);
+    }
+
+    /// Like `parse_result` (argv[0] is skipped), but a parse error is returned in the status instead of thrown
+    ParseResult try_parse_result(int argc, const char *const *argv) const {
+        detail::TokenStream tokens{argc > 1 ? static_cast<size_t>(argc - 1) : 0, argv + 1};
+        return _parse_result(tokens);
     }
 
     /// Provide a function to print a help message. The function gets access to the App pointer and error.
@@ -772,16 +986,27 @@ class App {
         return e.get_exit_code();
     }
 
+    /// Print a nice error message for the result of `try_parse` (or help, if asked for) and return the exit code
+    int exit(const ParseStatus &status, std::ostream &out = std::cout, std::ostream &err = std::cerr) const {
+        if(status.get_kind() == ParseStatus::Kind::CallForHelp)
+            out << help();
+        else if(!status.ok() && failure_message_)
+            status.visit([this, &err](const Error &e) { err << failure_message_(this, e) << std::flush; });
+        return status.get_exit_code();
+    }
+
     /// Reset the parsed data
     void reset() {
 
         parsed_ = false;
         missing_.clear();
         parsed_subcommands_.clear();
+        given_.clear();
 
         for(const Option_p &opt : options_) {
             opt->clear();
         }
+        results_arena_.clear();
         for(const App_p &app : subcommands_) {
             app->reset();
         }
@@ -791,14 +1016,21 @@ class App {
     /// @name Post parsing
     ///@{
 
+    /// Convert the values of all the lazy options given (here and in subcommands) now, so any error is thrown up front
+    void convert_lazy() {
+        for(const Option_p &opt : options_)
+            if(opt->get_lazy() && opt->count() > 0 && !opt->get_callback_run())
+                opt->run_callback();
+        for(const App_p &app : subcommands_)
+            app->convert_lazy();
+    }
+
     /// Counts the number of times the given option was passed.
     size_t count(std::string name) const {
-        for(const Option_p &opt : options_) {
-            if(opt->check_name(name)) {
-                return opt->count();
-            }
-        }
-        throw OptionNotFound(name);
+        const Option *opt = _find_option(name);
+        if(opt == nullptr)
+            throw OptionNotFound(name);
+        return opt->count();
     }
 
     /// Get a subcommand pointer list to the currently selected subcommands (after parsing by default, in command line
@@ -1095,19 +1327,148 @@ class App {
     ///@}
 
   protected:
-    /// Check the options to make sure there are no conflicts.
+    /// Add all the names of an option to the lookup tables
+    void _index_option(Option *opt) {
+        for(const std::string &sname : opt->snames_)
+            snames_index_.add(sname[0], opt->get_ignore_case(), opt);
+        for(const std::string &lname : opt->lnames_)
+            lnames_index_.add(lname, opt->get_ignore_case(), opt);
+        if(opt->get_positional())
+            pnames_index_.add(opt->pname_, opt->get_ignore_case(), opt);
+    }
+
+    /// Remove all the names of an option from the lookup tables
+    void _unindex_option(Option *opt) {
+        for(const std::string &sname : opt->snames_)
+            snames_index_.remove(sname[0], opt);
+        for(const std::string &lname : opt->lnames_)
+            lnames_index_.remove(lname, opt);
+        if(opt->get_positional())
+            pnames_index_.remove(opt->pname_, opt);
+    }
+
+    /// Find another option that shares a (non-positional) name with this one, taking ignore_case into account
+    Option *_find_conflict(const Option *opt) const {
+        Option *self = const_cast<Option *>(opt);
+        for(const std::string &sname : opt->snames_)
+            if(Option *other = snames_index_.conflict(sname[0], opt->get_ignore_case(), self))
+                return other;
+        for(const std::string &lname : opt->lnames_)
+            if(Option *other = lnames_index_.conflict(lname, opt->get_ignore_case(), self))
+                return other;
+        return nullptr;
+    }
+
+    /// Find an option by long name (without the "--"), or nullptr
+    Option *_find_lname(const std::string &name) const { return lnames_index_.find(name); }
+
+    /// Find an option by long name (without the "--"), or nullptr
+    Option *_find_lname(const char *name, std::size_t size) const { return lnames_index_.find(name, size); }
+
+    /// Find an option by a long name given on the command line, which can be abbreviated if allowed. An ambiguous
+    /// abbreviation finds nothing.
+    Option *_find_long(const char *name, std::size_t size) const {
+        Option *opt = lnames_index_.find(name, size);
+        if(opt == nullptr && allow_abbreviations_) {
+            bool ambiguous;
+            opt = lnames_trie_.find(name, size, ambiguous);
+        }
+        return opt;
+    }
+
+    /// Find an option by short name (without the "-"), or nullptr
+    Option *_find_sname(const std::string &name) const {
+        return name.size() == 1 ? snames_index_.find(name[0]) : nullptr;
+    }
+
+    /// Find an option the same way Option::check_name matches it ("-a", "--long", or a positional name), or nullptr.
+    /// The option `skip` is never returned.
+    Option *_find_option(const std::string &name, const Option *skip = nullptr) const {
+        Option *opt;
+        if(name.length() > 2 && name.compare(0, 2, "--") == 0)
+            opt = lnames_index_.find(name.data() + 2, name.size() - 2);
+        else if(name.length() > 1 && name[0] == '-')
+            opt = name.size() == 2 ? snames_index_.find(name[1]) : nullptr;
+        else
+            return pnames_index_.find_if(name.data(), name.size(), [skip](const Option *v) { return v != skip; });
+        return opt != skip ? opt : nullptr;
+    }
+
+    /// Check the options to make sure there are no conflicts, and prepare the tables used while parsing.
     ///
     /// Currently checks to see if multiple positionals exist with -1 args
-    void _validate() const {
+    void _validate() {
         auto count = std::count_if(std::begin(options_), std::end(options_), [](const Option_p &opt) {
             return opt->get_items_expected() < 0 && opt->get_positional();
         });
         if(count > 1)
             throw InvalidError(name_);
+
+        // A subcommand name can be matched at this level or in any parent, so they all go in one table
+        subcommand_resolver_.clear();
+        for(const App *app = this; app != nullptr; app = app->parent_)
+            for(const App_p &com : app->subcommands_)
+                subcommand_resolver_.add(com->name_, com->ignore_case_, com.get());
+
+        lnames_trie_.clear();
+        if(allow_abbreviations_)
+            for(const Option_p &opt : options_)
+                for(const std::string &lname : opt->lnames_)
+                    lnames_trie_.add(lname, opt->get_ignore_case(), opt.get());
+
+        positionals_.clear();
+        env_bits_ = detail::OptionBits(options_.size());
+        required_bits_ = detail::OptionBits(options_.size());
+        for(const Option_p &opt : options_) {
+            if(opt->get_positional())
+                positionals_.push_back(opt.get());
+            if(!opt->envname_.empty())
+                env_bits_.set(opt->id_);
+            if(opt->get_required())
+                required_bits_.set(opt->id_);
+
+            // Constraints between options of this App are checked by id, others by pointer
+            opt->needs_bits_ = detail::OptionBits(options_.size());
+            opt->excludes_bits_ = detail::OptionBits(options_.size());
+            opt->outside_constraints_ = false;
+            for(const Option *opt_req : opt->requires_) {
+                if(opt_req->parent_ == this)
+                    opt->needs_bits_.set(opt_req->id_);
+                else
+                    opt->outside_constraints_ = true;
+            }
+            for(const Option *opt_ex : opt->excludes_) {
+                if(opt_ex->parent_ == this)
+                    opt->excludes_bits_.set(opt_ex->id_);
+                else
+                    opt->outside_constraints_ = true;
+            }
+        }
+
+        exclusive_bits_.clear();
+        for(const std::vector<Option *> &group : exclusive_groups_) {
+            exclusive_bits_.emplace_back(options_.size());
+            for(const Option *opt : group)
+                exclusive_bits_.back().set(opt->id_);
+        }
+
         for(const App_p &app : subcommands_)
             app->_validate();
     }
 
+    /// Keep the tables of this App and all its subcommands
+    void _freeze() {
+        frozen_ = true;
+        for(const App_p &app : subcommands_)
+            app->_freeze();
+    }
+
+    /// Throw if the App is frozen
+    void _check_not_frozen() const {
+        if(frozen_)
+            throw IncorrectConstruction::Frozen(name_);
+    }
+
     /// Internal function to run (App) callback, top down
     void run_callback() {
         pre_callback();
@@ -1118,145 +1479,421 @@ class App {
         }
     }
 
-    /// Check to see if a subcommand is valid. Give up immediately if subcommand max has been reached.
-    bool _valid_subcommand(const std::string &current) const {
-        // Don't match if max has been reached - but still check parents
-        if(require_subcommand_max_ != 0 && parsed_subcommands_.size() >= require_subcommand_max_) {
-            return parent_ != nullptr && parent_->_valid_subcommand(current);
+    /// @name Parse state
+    /// The parse functions take a ParseResult to fill; if it is nullptr, the state is stored in the App and its options
+    /// as usual. With a ParseResult, the App is only read.
+    ///@{
+
+    /// Number of values an option has
+    size_t _count(const Option *opt, const ParseResult *res) const {
+        return res == nullptr ? opt->count() : res->count(opt);
+    }
+
+    /// Store a value for an option (of this App), marking it as given
+    void _add_result(Option *opt, string_view value, ParseResult *res) {
+        if(res == nullptr) {
+            opt->add_result(value);
+        } else if(res->add_result(opt, value, opt->get_delimiter()) == 0) {
+            res->state(this).given.set(opt->id_);
         }
+    }
 
-        for(const App_p &com : subcommands_)
-            if(com->check_name(current) && !*com)
-                return true;
+    /// Store a value for an option from the command line, recording the parse order
+    void _add_parsed(Option *opt, string_view value, ParseResult *res) {
+        int before = static_cast<int>(_count(opt, res));
+        _add_result(opt, value, res);
+        _parse_order(res).push_back(opt);
+
+        // Keep the count of positionals still waiting for values (a positional can also have an option name), a
+        // delimited value can fill several at once
+        int expected = opt->get_items_expected();
+        if(opt->get_positional() && before < expected && static_cast<int>(_count(opt, res)) >= expected) {
+            detail::PositionalCursor &positionals = _positional_cursor(res);
+            positionals.unfilled--;
+            if(opt->get_required())
+                positionals.required_unfilled--;
+        }
+    }
+
+    /// True if this App was parsed
+    bool _parsed(const ParseResult *res) const {
+        if(res == nullptr)
+            return parsed_;
+        const ParseResult::AppState *state = res->find_state(this);
+        return state != nullptr && state->parsed;
+    }
 
-        // Check parent if exists, else return false
-        return parent_ != nullptr && parent_->_valid_subcommand(current);
+    /// Mark this App as parsed
+    void _set_parsed(ParseResult *res) {
+        if(res == nullptr)
+            parsed_ = true;
+        else
+            res->state(this).parsed = true;
     }
 
-    /// Selects a Classifier enum based on the type of the current argument
-    detail::Classifer _recognize(const std::string &current) const {
-        std::string dummy1, dummy2;
+    /// The unused arguments
+    missing_t &_missing(ParseResult *res) { return res == nullptr ? missing_ : res->state(this).missing; }
 
-        if(current == "--")
+    /// The options in parse order
+    std::vector<Option *> &_parse_order(ParseResult *res) {
+        return res == nullptr ? parse_order_ : res->state(this).parse_order;
+    }
+
+    /// The subcommands parsed, in order
+    std::vector<App *> &_parsed_subcommands(ParseResult *res) {
+        return res == nullptr ? parsed_subcommands_ : res->state(this).subcommands;
+    }
+
+    /// The ids of the options given a value
+    const detail::OptionBits &_given(const ParseResult *res) const {
+        if(res == nullptr)
+            return given_;
+        const ParseResult::AppState *state = res->find_state(this);
+        return state == nullptr ? empty_bits() : state->given;
+    }
+
+    /// An empty set of ids
+    static const detail::OptionBits &empty_bits() {
+        static const detail::OptionBits empty;
+        return empty;
+    }
+
+    /// How far the positionals have been filled
+    detail::PositionalCursor &_positional_cursor(ParseResult *res) {
+        return res == nullptr ? positional_cursor_ : res->state(this).positionals;
+    }
+
+    /// Where the error of a parse goes, the same for every App of the tree
+    ParseStatus &_status(ParseResult *res) {
+        if(res != nullptr)
+            return res->status_;
+        App *top = this;
+        while(top->parent_ != nullptr)
+            top = top->parent_;
+        return top->status_;
+    }
+
+    /// Record why the parse failed, and return false for the parse functions to pass up
+    template <typename... Args> bool _fail(ParseResult *res, ParseStatus::Kind kind, Args &&... args) {
+        _status(res) = ParseStatus(kind, std::forward<Args>(args)...);
+        return false;
+    }
+
+    ///@}
+
+    /// Check to see if a subcommand is valid here or in any parent. Subcommands already parsed and subcommands of an
+    /// App that has reached its subcommand max do not match.
+    bool _valid_subcommand(const detail::Token &current, ParseResult *res) {
+        if(subcommand_resolver_.empty())
+            return false;
+        return subcommand_resolver_.find_if(current.data, current.size, [res](App *com) {
+            App *owner = com->parent_;
+            return !com->_parsed(res) && (owner->require_subcommand_max_ == 0 ||
+                                          owner->_parsed_subcommands(res).size() < owner->require_subcommand_max_);
+        }) != nullptr;
+    }
+
+    /// Selects a Classifier enum based on the type of the current argument. Only the subcommand check is done here,
+    /// the rest was worked out when the argument was classified.
+    detail::Classifer _recognize(const detail::Token &current, ParseResult *res) {
+        if(current.kind == detail::Classifer::POSITIONAL_MARK)
             return detail::Classifer::POSITIONAL_MARK;
-        if(_valid_subcommand(current))
-            return detail::Classifer::SUBCOMMAND;
-        if(detail::split_long(current, dummy1, dummy2))
-            return detail::Classifer::LONG;
-        if(detail::split_short(current, dummy1, dummy2))
+        if(current.cluster_tail())
             return detail::Classifer::SHORT;
-        return detail::Classifer::NONE;
+        if(_valid_subcommand(current, res))
+            return detail::Classifer::SUBCOMMAND;
+        return current.kind;
+    }
+
+    /// Parse a command line without throwing, taking the name from the program name if it is not set
+    ParseStatus _try_parse(detail::TokenStream &tokens, const char *program) {
+        if(name_.empty())
+            name_ = program;
+        _parse_tokens(tokens);
+        return _status(nullptr);
+    }
+
+    /// The real work is done here, shared by all the parse overloads. Returns false, with the error in the status of
+    /// the App, if the parse fails.
+    bool _parse_tokens(detail::TokenStream &tokens) {
+        _status(nullptr) = ParseStatus();
+        if(!frozen_)
+            _validate();
+        _compact_results();
+        if(response_files_ && !tokens.expand_response_files(_status(nullptr)))
+            return false;
+        if(!_parse(tokens, nullptr))
+            return false;
+        if(!tokens.stopped())
+            run_callback();
+        return true;
+    }
+
+    /// Release the text no result refers to any more (results replaced by validators, cleared, or made for a default)
+    /// once it is most of the arena, so parsing again without a reset does not keep growing it
+    void _compact_results() {
+        std::size_t live = 0;
+        for(const Option_p &opt : options_)
+            for(const detail::ResultSpan &span : opt->results_)
+                live += span.size;
+        if(live == 0) {
+            results_arena_.clear();
+        } else if(results_arena_.size() > 2 * live) {
+            detail::ResultArena compacted;
+            for(const Option_p &opt : options_)
+                for(detail::ResultSpan &span : opt->results_)
+                    span = compacted.add(results_arena_.view(span));
+            results_arena_ = std::move(compacted);
+        }
+        for(const App_p &app : subcommands_)
+            app->_compact_results();
     }
 
-    /// Internal parse function
-    void _parse(std::vector<std::string> &args) {
-        parsed_ = true;
-        bool positional_only = false;
+    /// The real work for parse_result
+    ParseResult _parse_result(detail::TokenStream &tokens) const {
+        if(!frozen_)
+            throw IncorrectConstruction::NotFrozen(name_);
+        ParseResult result{this};
+        if(response_files_ && !tokens.expand_response_files(result.status_))
+            return result;
+        // With a result to fill, the parse functions do not change the App
+        const_cast<App *>(this)->_parse(tokens, &result);
+        return result;
+    }
+
+    /// Internal parse function: give every argument to the App it belongs to, then process the Apps. This and the
+    /// functions it calls return false on an error, after recording it with `_fail`.
+    bool _parse(detail::TokenStream &args, ParseResult *res) {
+        ParseCursor cursor;
+        _enter(cursor, res);
 
         while(!args.empty()) {
-            _parse_single(args, positional_only);
+            if(!cursor.apps.back()->_parse_single(args, cursor, res))
+                return false;
         }
 
-        if(help_ptr_ != nullptr && help_ptr_->count() > 0) {
-            throw CallForHelp();
+        // An option marked short_circuit ended the parse, nothing else is done
+        if(args.stopped())
+            return true;
+
+        return _finish(cursor, res);
+    }
+
+    /// Start giving the arguments to this App
+    void _enter(ParseCursor &cursor, ParseResult *res) {
+        _set_parsed(res);
+
+        detail::PositionalCursor &positionals = _positional_cursor(res);
+        positionals = detail::PositionalCursor();
+        for(const Option *opt : positionals_) {
+            if(opt->get_items_expected() > 0 && static_cast<int>(_count(opt, res)) < opt->get_items_expected()) {
+                positionals.unfilled++;
+                if(opt->get_required())
+                    positionals.required_unfilled++;
+            }
+        }
+
+        cursor.apps.push_back(this);
+        cursor.positional_only = false;
+    }
+
+    /// Process every App entered once all the arguments are parsed, the last one first
+    static bool _finish(ParseCursor &cursor, ParseResult *res) {
+        for(auto app = cursor.apps.rbegin(); app != cursor.apps.rend(); ++app)
+            if(!(*app)->_process(res))
+                return false;
+        return true;
+    }
+
+    /// Check if the next argument can be parsed with the arguments available so far (when they arrive one by one).
+    /// An option has to wait for all its values, and an unlimited option for the argument that ends them.
+    bool _ready(const detail::TokenStream &args, const ParseCursor &cursor, ParseResult *res) {
+        const detail::Token &current = args.front();
+        detail::Classifer kind = cursor.positional_only ? detail::Classifer::NONE : _recognize(current, res);
+        if(kind != detail::Classifer::LONG && kind != detail::Classifer::SHORT)
+            return true;
+
+        // Find the option the same way _parse_arg does, falling through to the parents
+        const char *name = current.data + current.name_begin;
+        App *app = this;
+        Option *op = nullptr;
+        for(;;) {
+            op = kind == detail::Classifer::LONG ? app->_find_long(name, current.name_size)
+                                                 : app->snames_index_.find(name[0]);
+            if(op != nullptr || app->parent_ == nullptr || !app->fallthrough_)
+                break;
+            app = app->parent_;
+        }
+        if(op == nullptr)
+            return true;
+
+        int num = op->get_items_expected();
+        if(num == 0)
+            return true;
+        if(num > 0)
+            return args.size() > static_cast<size_t>(current.value_size > 0 ? num - 1 : num);
+        for(size_t i = 1; i < args.size(); i++)
+            if(app->_recognize(args[i], res) != detail::Classifer::NONE)
+                return true;
+        return false;
+    }
+
+    /// Everything after the arguments are parsed: help, config file, environment, callbacks and requirements
+    bool _process(ParseResult *res) {
+        if(help_ptr_ != nullptr && _count(help_ptr_, res) > 0) {
+            return _fail(res, ParseStatus::Kind::CallForHelp);
         }
 
         // Process an INI file
         if(config_ptr_ != nullptr) {
-            if(*config_ptr_) {
-                config_ptr_->run_callback();
-                config_required_ = true;
+            std::string config_name = config_name_;
+            bool config_required = config_required_;
+            if(_count(config_ptr_, res) > 0) {
+                if(res == nullptr) {
+                    if(!config_ptr_->run_callback(_status(res)))
+                        return false;
+                    config_required_ = true;
+                    config_name = config_name_;
+                } else {
+                    config_name = res->results(config_ptr_).back();
+                }
+                config_required = true;
             }
-            if(!config_name_.empty()) {
-                try {
-                    std::vector<detail::ini_ret_t> values = detail::parse_ini(config_name_);
+            if(!config_name.empty()) {
+                std::ifstream input{config_name};
+                if(input.good()) {
+                    std::vector<detail::ini_ret_t> values = detail::parse_ini(input);
                     while(!values.empty()) {
-                        if(!_parse_ini(values)) {
-                            throw INIError::Extras(values.back().fullname);
-                        }
+                        if(!_parse_ini(values, res))
+                            return false;
                     }
-                } catch(const FileError &) {
-                    if(config_required_)
-                        throw;
+                } else if(config_required) {
+                    return _fail(res, ParseStatus::Kind::FileMissing, config_name);
                 }
             }
         }
 
-        // Get envname options if not yet passed
-        for(const Option_p &opt : options_) {
-            if(opt->count() == 0 && !opt->envname_.empty()) {
-                char *buffer = nullptr;
-                std::string ename_string;
-
-#ifdef _MSC_VER
-                // Windows version
-                size_t sz = 0;
-                if(_dupenv_s(&buffer, &sz, opt->envname_.c_str()) == 0 && buffer != nullptr) {
-                    ename_string = std::string(buffer);
-                    free(buffer);
-                }
-#else
-                // This also works on Windows, but gives a warning
-                buffer = std::getenv(opt->envname_.c_str());
-                if(buffer != nullptr)
-                    ename_string = std::string(buffer);
-#endif
-
-                if(!ename_string.empty()) {
-                    opt->add_result(ename_string);
-                }
+        // Only the options that can matter are visited: the ones given, the ones with an environment variable, and
+        // the required ones. The value of an option comes from the first of these that has one: the command line, the
+        // config file (neither replaces a value already given), the environment, then the default (nothing stored).
+        const detail::OptionBits &given = _given(res);
+        detail::OptionBits visit = given;
+        visit.add(env_bits_);
+        visit.add(required_bits_);
+
+        // Every environment variable is read, then every callback runs, then everything is checked, so a conversion
+        // error is reported ahead of a missing or conflicting option wherever the options were added
+        for(size_t id = env_bits_.find_next(); id != detail::OptionBits::npos; id = env_bits_.find_next(id + 1))
+            if(!given.test(id))
+                _resolve_env(options_[id].get(), res);
+
+        // Run the callbacks (not for a separate result, the App is left alone, or a lazy option)
+        if(res == nullptr) {
+            for(size_t id = visit.find_next(); id != detail::OptionBits::npos; id = visit.find_next(id + 1)) {
+                Option *opt = options_[id].get();
+                if(_count(opt, res) > 0 && !opt->get_callback_run() && !opt->get_lazy() &&
+                   !opt->run_callback(_status(res)))
+                    return false;
             }
         }
 
-        // Process callbacks
-        for(const Option_p &opt : options_) {
-            if(opt->count() > 0 && !opt->get_callback_run()) {
-                opt->run_callback();
+        for(size_t id = visit.find_next(); id != detail::OptionBits::npos; id = visit.find_next(id + 1)) {
+            Option *opt = options_[id].get();
+            size_t count = _count(opt, res);
+            if(count == 0 && !opt->get_required())
+                continue;
+
+            // Make sure enough -N arguments parsed (+N is already handled in parsing function)
+            if(opt->get_items_expected() < 0 && count < static_cast<size_t>(-opt->get_items_expected()))
+                return _fail(res,
+                             ParseStatus::Kind::ArgumentMismatchAtLeast,
+                             opt->single_name(),
+                             "",
+                             -opt->get_items_expected());
+
+            // Required but empty
+            if(count == 0)
+                return _fail(res, ParseStatus::Kind::Required, opt->single_name());
+
+            size_t needed = opt->needs_bits_.first_andn(given);
+            if(needed != detail::OptionBits::npos)
+                return _fail(res, ParseStatus::Kind::Requires, opt->single_name(), options_[needed]->single_name());
+
+            size_t excluded = opt->excludes_bits_.first_and(given);
+            if(excluded != detail::OptionBits::npos)
+                return _fail(res, ParseStatus::Kind::Excludes, opt->single_name(), options_[excluded]->single_name());
+
+            // Options of other Apps
+            if(opt->outside_constraints_) {
+                for(const Option *opt_req : opt->requires_)
+                    if(opt_req->parent_ != this && _count(opt_req, res) == 0)
+                        return _fail(res, ParseStatus::Kind::Requires, opt->single_name(), opt_req->single_name());
+                for(const Option *opt_ex : opt->excludes_)
+                    if(opt_ex->parent_ != this && _count(opt_ex, res) != 0)
+                        return _fail(res, ParseStatus::Kind::Excludes, opt->single_name(), opt_ex->single_name());
             }
         }
 
-        // Verify required options
-        for(const Option_p &opt : options_) {
-            // Required or partially filled
-            if(opt->get_required() || opt->count() != 0) {
-                // Make sure enough -N arguments parsed (+N is already handled in parsing function)
-                if(opt->get_items_expected() < 0 && opt->count() < static_cast<size_t>(-opt->get_items_expected()))
-                    throw ArgumentMismatch::AtLeast(opt->single_name(), -opt->get_items_expected());
-
-                // Required but empty
-                if(opt->get_required() && opt->count() == 0)
-                    throw RequiredError(opt->single_name());
-            }
-            // Requires
-            for(const Option *opt_req : opt->requires_)
-                if(opt->count() > 0 && opt_req->count() == 0)
-                    throw RequiresError(opt->single_name(), opt_req->single_name());
-            // Excludes
-            for(const Option *opt_ex : opt->excludes_)
-                if(opt->count() > 0 && opt_ex->count() != 0)
-                    throw ExcludesError(opt->single_name(), opt_ex->single_name());
+        // Mutually exclusive groups
+        for(const detail::OptionBits &group : exclusive_bits_) {
+            size_t first = group.first_and(given);
+            if(first == detail::OptionBits::npos)
+                continue;
+            size_t second = group.first_and(given, first + 1);
+            if(second != detail::OptionBits::npos)
+                return _fail(
+                    res, ParseStatus::Kind::Excludes, options_[first]->single_name(), options_[second]->single_name());
         }
 
-        auto selected_subcommands = get_subcommands();
-        if(require_subcommand_min_ > selected_subcommands.size())
-            throw RequiredError::Subcommand(require_subcommand_min_);
+        if(require_subcommand_min_ > _parsed_subcommands(res).size())
+            return _fail(res, ParseStatus::Kind::RequiredSubcommand, "", "", static_cast<int>(require_subcommand_min_));
 
         // Convert missing (pairs) to extras (string only)
         if(!(allow_extras_ || prefix_command_)) {
-            size_t num_left_over = remaining_size();
-            if(num_left_over > 0) {
-                args = remaining(false);
-                std::reverse(std::begin(args), std::end(args));
-                throw ExtrasError(args);
+            const missing_t &missing = _missing(res);
+            bool left_over = std::any_of(
+                std::begin(missing), std::end(missing), [](const std::pair<detail::Classifer, std::string> &val) {
+                    return val.first != detail::Classifer::POSITIONAL_MARK;
+                });
+            if(left_over) {
+                std::vector<std::string> extras;
+                for(const std::pair<detail::Classifer, std::string> &miss : missing)
+                    extras.push_back(miss.second);
+                std::reverse(std::begin(extras), std::end(extras));
+                return _fail(res, ParseStatus::Kind::Extras, "", "", 0, 0, std::move(extras));
             }
         }
+        return true;
     }
 
-    /// Parse one ini param, return false if not found in any subcommand, remove if it is
+    /// Set an option from its environment variable, if it has a value
+    void _resolve_env(Option *opt, ParseResult *res) {
+        char *buffer = nullptr;
+        std::string ename_string;
+
+#ifdef _MSC_VER
+        // Windows version
+        size_t sz = 0;
+        if(_dupenv_s(&buffer, &sz, opt->envname_.c_str()) == 0 && buffer != nullptr) {
+            ename_string = std::string(buffer);
+            free(buffer);
+        }
+#else
+        // This also works on Windows, but gives a warning
+        buffer = std::getenv(opt->envname_.c_str());
+        if(buffer != nullptr)
+            ename_string = std::string(buffer);
+#endif
+
+        if(!ename_string.empty()) {
+            _add_result(opt, ename_string, res);
+        }
+    }
+
+    /// Parse one ini param and remove it, return false (an error) if it is not found in any subcommand
     ///
     /// If this has more than one dot.separated.name, go into the subcommand matching it
-    /// Returns true if it managed to find the option, if false you'll need to remove the arg manually.
-    bool _parse_ini(std::vector<detail::ini_ret_t> &args) {
+    bool _parse_ini(std::vector<detail::ini_ret_t> &args, ParseResult *res) {
         detail::ini_ret_t &current = args.back();
         std::string parent = current.parent(); // respects current.level
         std::string name = current.name();
@@ -1264,54 +1901,51 @@ class App {
         // If a parent is listed, go to a subcommand
         if(!parent.empty()) {
             current.level++;
-            for(const App_p &com : subcommands_)
-                if(com->check_name(parent))
-                    return com->_parse_ini(args);
-            return false;
+            App *com = subcommand_index_.find(parent);
+            if(com == nullptr)
+                return _fail(res, ParseStatus::Kind::INIExtras, current.fullname);
+            return com->_parse_ini(args, res);
         }
 
-        auto op_ptr = std::find_if(
-            std::begin(options_), std::end(options_), [name](const Option_p &v) { return v->check_lname(name); });
+        Option *op = _find_lname(name);
 
-        if(op_ptr == std::end(options_)) {
+        if(op == nullptr) {
             if(allow_ini_extras_) {
                 // Should we worry about classifying the extras properly?
-                missing_.emplace_back(detail::Classifer::NONE, current.fullname);
+                _missing(res).emplace_back(detail::Classifer::NONE, current.fullname);
                 args.pop_back();
                 return true;
             }
-            return false;
+            return _fail(res, ParseStatus::Kind::INIExtras, current.fullname);
         }
 
-        // Let's not go crazy with pointer syntax
-        Option_p &op = *op_ptr;
-
         if(!op->get_configurable())
-            throw INIError::NotConfigurable(current.fullname);
+            return _fail(res, ParseStatus::Kind::ININotConfigurable, current.fullname);
 
-        if(op->results_.empty()) {
+        if(_count(op, res) == 0) {
             // Flag parsing
             if(op->get_type_size() == 0) {
                 if(current.inputs.size() == 1) {
                     std::string val = current.inputs.at(0);
                     val = detail::to_lower(val);
                     if(val == "true" || val == "on" || val == "yes")
-                        op->results_ = {""};
+                        _add_result(op, "", res);
                     else if(val == "false" || val == "off" || val == "no")
                         ;
-                    else
-                        try {
-                            size_t ui = std::stoul(val);
-                            for(size_t i = 0; i < ui; i++)
-                                op->results_.emplace_back("");
-                        } catch(const std::invalid_argument &) {
-                            throw ConversionError::TrueFalse(current.fullname);
-                        }
+                    else {
+                        size_t ui;
+                        if(detail::parse_number(val, ui) != detail::NumberError::None)
+                            return _fail(res, ParseStatus::Kind::ConversionTrueFalse, current.fullname);
+                        for(size_t i = 0; i < ui; i++)
+                            _add_result(op, "", res);
+                    }
                 } else
-                    throw ConversionError::TooManyInputsFlag(current.fullname);
+                    return _fail(res, ParseStatus::Kind::ConversionTooManyInputsFlag, current.fullname);
             } else {
-                op->results_ = current.inputs;
-                op->run_callback();
+                for(const std::string &input : current.inputs)
+                    _add_result(op, input, res);
+                if(res == nullptr && !op->get_lazy() && !op->run_callback(_status(res)))
+                    return false;
             }
         }
 
@@ -1321,204 +1955,221 @@ class App {
 
     /// Parse "one" argument (some may eat more than one), delegate to parent if fails, add to missing if missing from
     /// master
-    void _parse_single(std::vector<std::string> &args, bool &positional_only) {
+    bool _parse_single(detail::TokenStream &args, ParseCursor &cursor, ParseResult *res) {
 
-        detail::Classifer classifer = positional_only ? detail::Classifer::NONE : _recognize(args.back());
+        detail::Classifer classifer = cursor.positional_only ? detail::Classifer::NONE : _recognize(args.front(), res);
         switch(classifer) {
         case detail::Classifer::POSITIONAL_MARK:
-            missing_.emplace_back(classifer, args.back());
-            args.pop_back();
-            positional_only = true;
+            _missing(res).emplace_back(classifer, args.front().str());
+            args.pop_front();
+            cursor.positional_only = true;
             break;
         case detail::Classifer::SUBCOMMAND:
-            _parse_subcommand(args);
-            break;
+            return _parse_subcommand(args, cursor, res);
         case detail::Classifer::LONG:
             // If already parsed a subcommand, don't accept options_
-            _parse_arg(args, true);
-            break;
+            return _parse_arg(args, true, res);
         case detail::Classifer::SHORT:
             // If already parsed a subcommand, don't accept options_
-            _parse_arg(args, false);
-            break;
+            return _parse_arg(args, false, res);
         case detail::Classifer::NONE:
             // Probably a positional or something for a parent (sub)command
-            _parse_positional(args);
+            _parse_positional(args, res);
         }
+        return true;
     }
 
-    /// Count the required remaining positional arguments
-    size_t _count_remaining_positionals(bool required = false) const {
-        size_t retval = 0;
-        for(const Option_p &opt : options_)
-            if(opt->get_positional() && (!required || opt->get_required()) && opt->get_items_expected() > 0 &&
-               static_cast<int>(opt->count()) < opt->get_items_expected())
-                retval = static_cast<size_t>(opt->get_items_expected()) - opt->count();
-
-        return retval;
+    /// Count the positionals (or only the required ones) that still need values
+    size_t _count_remaining_positionals(ParseResult *res, bool required = false) {
+        const detail::PositionalCursor &positionals = _positional_cursor(res);
+        return required ? positionals.required_unfilled : positionals.unfilled;
     }
 
     /// Parse a positional, go up the tree to check
-    void _parse_positional(std::vector<std::string> &args) {
+    void _parse_positional(detail::TokenStream &args, ParseResult *res) {
 
-        std::string positional = args.back();
-        for(const Option_p &opt : options_) {
+        const detail::Token &positional = args.front();
+
+        // Positionals fill in order, so the cursor only moves forward past the full ones
+        detail::PositionalCursor &positionals = _positional_cursor(res);
+        for(; positionals.next < positionals_.size(); positionals.next++) {
+            Option *opt = positionals_[positionals.next];
             // Eat options, one by one, until done
-            if(opt->get_positional() &&
-               (static_cast<int>(opt->count()) < opt->get_items_expected() || opt->get_items_expected() < 0)) {
+            if(static_cast<int>(_count(opt, res)) < opt->get_items_expected() || opt->get_items_expected() < 0) {
 
-                opt->add_result(positional);
-                parse_order_.push_back(opt.get());
-                args.pop_back();
+                _add_parsed(opt, positional.text(), res);
+                args.pop_front();
                 return;
             }
         }
 
         if(parent_ != nullptr && fallthrough_)
-            return parent_->_parse_positional(args);
+            return parent_->_parse_positional(args, res);
         else {
-            args.pop_back();
-            missing_.emplace_back(detail::Classifer::NONE, positional);
+            _missing(res).emplace_back(detail::Classifer::NONE, positional.str());
+            args.pop_front();
 
             if(prefix_command_) {
                 while(!args.empty()) {
-                    missing_.emplace_back(detail::Classifer::NONE, args.back());
-                    args.pop_back();
+                    _missing(res).emplace_back(detail::Classifer::NONE, args.front().str());
+                    args.pop_front();
                 }
             }
         }
     }
 
-    /// Parse a subcommand, modify args and continue
+    /// Parse a subcommand, modify args and continue (the following arguments go to the subcommand)
     ///
     /// Unlike the others, this one will always allow fallthrough
-    void _parse_subcommand(std::vector<std::string> &args) {
-        if(_count_remaining_positionals(/* required */ true) > 0)
-            return _parse_positional(args);
-        for(const App_p &com : subcommands_) {
-            if(com->check_name(args.back())) {
-                args.pop_back();
-                if(std::find(std::begin(parsed_subcommands_), std::end(parsed_subcommands_), com.get()) ==
-                   std::end(parsed_subcommands_))
-                    parsed_subcommands_.push_back(com.get());
-                com->_parse(args);
-                return;
-            }
+    bool _parse_subcommand(detail::TokenStream &args, ParseCursor &cursor, ParseResult *res) {
+        if(_count_remaining_positionals(res, /* required */ true) > 0) {
+            _parse_positional(args, res);
+            return true;
+        }
+        App *com = subcommand_index_.find(args.front().data, args.front().size);
+        if(com != nullptr) {
+            args.pop_front();
+            std::vector<App *> &parsed_subcommands = _parsed_subcommands(res);
+            if(std::find(std::begin(parsed_subcommands), std::end(parsed_subcommands), com) ==
+               std::end(parsed_subcommands))
+                parsed_subcommands.push_back(com);
+            com->_enter(cursor, res);
+            return true;
         }
         if(parent_ != nullptr)
-            return parent_->_parse_subcommand(args);
+            return parent_->_parse_subcommand(args, cursor, res);
         else
-            throw HorribleError("Subcommand " + args.back() + " missing");
+            return _fail(res, ParseStatus::Kind::Horrible, "Subcommand " + args.front().str() + " missing");
     }
 
     /// Parse a short (false) or long (true) argument, must be at the top of the list
-    void _parse_arg(std::vector<std::string> &args, bool second_dash) {
+    bool _parse_arg(detail::TokenStream &args, bool second_dash, ParseResult *res) {
 
         detail::Classifer current_type = second_dash ? detail::Classifer::LONG : detail::Classifer::SHORT;
 
-        std::string current = args.back();
-
-        std::string name;
-        std::string value;
-        std::string rest;
+        const detail::Token &current = args.front();
 
-        if(second_dash) {
-            if(!detail::split_long(current, name, value))
-                throw HorribleError("Long parsed but missing (you should not see this):" + args.back());
-        } else {
-            if(!detail::split_short(current, name, rest))
-                throw HorribleError("Short parsed but missing! You should not see this");
+        if(current.kind != current_type) {
+            if(second_dash)
+                return _fail(res,
+                             ParseStatus::Kind::Horrible,
+                             "Long parsed but missing (you should not see this):" + current.str());
+            else
+                return _fail(res, ParseStatus::Kind::Horrible, "Short parsed but missing! You should not see this");
         }
 
-        auto op_ptr = std::find_if(std::begin(options_), std::end(options_), [name, second_dash](const Option_p &opt) {
-            return second_dash ? opt->check_lname(name) : opt->check_sname(name);
-        });
+        const char *name = current.data + current.name_begin;
+        Option *op = second_dash ? _find_long(name, current.name_size) : snames_index_.find(name[0]);
 
         // Option not found
-        if(op_ptr == std::end(options_)) {
+        if(op == nullptr) {
             // If a subcommand, try the master command
             if(parent_ != nullptr && fallthrough_)
-                return parent_->_parse_arg(args, second_dash);
+                return parent_->_parse_arg(args, second_dash, res);
             // Otherwise, add to missing
             else {
-                args.pop_back();
-                missing_.emplace_back(current_type, current);
-                return;
+                _missing(res).emplace_back(current_type, current.str());
+                args.pop_front();
+                return true;
             }
         }
 
-        args.pop_back();
+        int num = op->get_items_expected();
 
-        // Get a reference to the pointer to make syntax bearable
-        Option_p &op = *op_ptr;
+        // -abc, where a is a flag: the argument moves on to b in place, and is parsed again from the current App
+        if(!second_dash && num == 0 && args.next_short()) {
+            _add_parsed(op, "", res);
+            return op->get_short_circuit() ? _short_circuit(op, args, res) : true;
+        }
 
-        int num = op->get_items_expected();
+        // --this=value or -Trest (a view, the text of the argument outlives the stream)
+        string_view value = current.value_view();
+        args.pop_front();
 
         // Make sure we always eat the minimum for unlimited vectors
         int collected = 0;
 
         // --this=value
-        if(!value.empty()) {
+        if(second_dash && !value.empty()) {
             // If exact number expected
             if(num > 0)
                 num--;
-            op->add_result(value);
-            parse_order_.push_back(op.get());
+            _add_parsed(op, value, res);
             collected += 1;
+            value = string_view();
         } else if(num == 0) {
-            op->add_result("");
-            parse_order_.push_back(op.get());
+            _add_parsed(op, "", res);
             // -Trest
-        } else if(!rest.empty()) {
+        } else if(!value.empty()) {
             if(num > 0)
                 num--;
-            op->add_result(rest);
-            parse_order_.push_back(op.get());
-            rest = "";
+            _add_parsed(op, value, res);
+            value = string_view();
             collected += 1;
         }
 
         // Unlimited vector parser
         if(num < 0) {
-            while(!args.empty() && _recognize(args.back()) == detail::Classifer::NONE) {
+            while(!args.empty() && _recognize(args.front(), res) == detail::Classifer::NONE) {
                 if(collected >= -num) {
                     // We could break here for allow extras, but we don't
 
                     // If any positionals remain, don't keep eating
-                    if(_count_remaining_positionals() > 0)
+                    if(_count_remaining_positionals(res) > 0)
                         break;
                 }
-                op->add_result(args.back());
-                parse_order_.push_back(op.get());
-                args.pop_back();
+                _add_parsed(op, args.front().text(), res);
+                args.pop_front();
                 collected++;
             }
 
             // Allow -- to end an unlimited list and "eat" it
-            if(!args.empty() && _recognize(args.back()) == detail::Classifer::POSITIONAL_MARK)
-                args.pop_back();
+            if(!args.empty() && args.front().kind == detail::Classifer::POSITIONAL_MARK)
+                args.pop_front();
 
         } else {
             while(num > 0 && !args.empty()) {
                 num--;
-                std::string current_ = args.back();
-                args.pop_back();
-                op->add_result(current_);
-                parse_order_.push_back(op.get());
+                _add_parsed(op, args.front().text(), res);
+                args.pop_front();
             }
 
             if(num > 0) {
-                throw ArgumentMismatch::TypedAtLeast(op->single_name(), num, op->get_type_name());
+                return _fail(
+                    res, ParseStatus::Kind::ArgumentMismatchTypedAtLeast, op->single_name(), op->get_type_name(), num);
             }
         }
 
-        if(!rest.empty()) {
-            rest = "-" + rest;
-            args.push_back(rest);
-        }
+        if(op->get_short_circuit())
+            return _short_circuit(op, args, res);
+
+        // Anything left after a flag that does not start like an option is an argument of its own
+        if(!second_dash && !value.empty())
+            args.push_front("-" + std::string(value.data(), value.size()));
+        return true;
+    }
+
+    /// End the parse at an option marked short_circuit. The help flag fails with CallForHelp right away; any other
+    /// option runs its callback, and the rest of the arguments are dropped.
+    bool _short_circuit(Option *op, detail::TokenStream &args, ParseResult *res) {
+        if(op == help_ptr_)
+            return _fail(res, ParseStatus::Kind::CallForHelp);
+        if(res == nullptr && !op->get_lazy() && !op->run_callback(_status(res)))
+            return false;
+        args.stop();
+        return true;
     }
 };
 
+inline void Option::_check_not_frozen() const { parent_->_check_not_frozen(); }
+
+inline void Option::_update_given() {
+    if(results_.empty())
+        parent_->given_.reset(id_);
+    else
+        parent_->given_.set(id_);
+}
+
 namespace FailureMessage {
 
 inline std::string simple(const App *app, const Error &e) {
@@ -1540,18 +2191,19 @@ namespace detail {
 /// This class is simply to allow tests access to App's protected functions
 struct AppFriend {
 
-    /// Wrap _parse_short, perfectly forward arguments and return
-    template <typename... Args>
-    static auto parse_arg(App *app, Args &&... args) ->
-        typename std::result_of<decltype (&App::_parse_arg)(App, Args...)>::type {
-        return app->_parse_arg(std::forward<Args>(args)...);
+    /// Wrap _parse_arg, classifying a reversed vector of arguments first
+    static void parse_arg(App *app, const std::vector<std::string> &args, bool second_dash) {
+        TokenStream tokens{args};
+        if(!app->_parse_arg(tokens, second_dash, nullptr))
+            app->_status(nullptr).raise();
     }
 
-    /// Wrap _parse_subcommand, perfectly forward arguments and return
-    template <typename... Args>
-    static auto parse_subcommand(App *app, Args &&... args) ->
-        typename std::result_of<decltype (&App::_parse_subcommand)(App, Args...)>::type {
-        return app->_parse_subcommand(std::forward<Args>(args)...);
+    /// Wrap _parse_subcommand, classifying a reversed vector of arguments first
+    static void parse_subcommand(App *app, const std::vector<std::string> &args) {
+        TokenStream tokens{args};
+        App::ParseCursor cursor;
+        if(!app->_parse_subcommand(tokens, cursor, nullptr))
+            app->_status(nullptr).raise();
     }
 };
 } // namespace detail
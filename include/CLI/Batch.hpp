@@ -0,0 +1,181 @@
+#pragma once
+
+// Distributed under the 3-Clause BSD License.  See accompanying
+// file LICENSE or https://github.com/CLIUtils/CLI11 for details.
+
+// This header is not included by CLI.hpp, since it needs a threading library to be linked.
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "CLI/App.hpp"
+#include "CLI/Error.hpp"
+#include "CLI/ParseResult.hpp"
+#include "CLI/ParseStatus.hpp"
+#include "CLI/StringView.hpp"
+#include "CLI/TokenStream.hpp"
+
+namespace CLI {
+
+/// The order of the items returned by parse_batch
+enum class BatchOrder {
+    /// The same order as the command lines given
+    Input,
+    /// The order the parses finished in
+    Completion
+};
+
+/// The outcome of parsing one command line of a batch: a result, or the error that stopped the parse
+struct BatchItem {
+    /// The position of the command line in the input
+    std::size_t index{0};
+
+    /// The result, or nullptr if the parse failed
+    std::unique_ptr<ParseResult> result;
+
+    /// Success, or the error that stopped the parse (the message is only made by `status.what()`)
+    ParseStatus status;
+
+    /// True if the command line was parsed without an error
+    bool ok() const { return result != nullptr; }
+};
+
+namespace detail {
+
+/// Convert the arguments of one command line to views (strings, char pointers and views are supported)
+template <typename Line> std::vector<string_view> to_views(const Line &line) {
+    std::vector<string_view> views;
+    for(const auto &arg : line)
+        views.emplace_back(arg);
+    return views;
+}
+
+/// Parse one command line of a batch into an item
+template <typename Line> void parse_batch_item(const App &app, const Line &line, BatchItem &item) {
+    ParseResult result = app.try_parse_result(to_views(line));
+    if(result.get_status().ok())
+        item.result.reset(new ParseResult(std::move(result)));
+    else
+        item.status = result.get_status();
+}
+
+} // namespace detail
+
+/// Parse many command lines with one App, spread over a number of threads (0 uses all the hardware threads).
+///
+/// The App is frozen first if needed, then every command line is parsed with `App::try_parse_result`. Threads claim
+/// small blocks of command lines as they go, so uneven lines still keep every thread busy. Parse errors are recorded in
+/// the items; an exception is rethrown once all the threads are done.
+///
+/// `lines` is a random access range of command lines, each a range of arguments (without the program name).
+template <typename Lines>
+std::vector<BatchItem>
+parse_batch(App &app, const Lines &lines, BatchOrder order = BatchOrder::Input, unsigned num_threads = 0) {
+    app.freeze();
+
+    const std::size_t total = static_cast<std::size_t>(std::distance(std::begin(lines), std::end(lines)));
+    std::vector<BatchItem> items(total);
+
+    if(num_threads == 0)
+        num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    num_threads = static_cast<unsigned>(std::min<std::size_t>(num_threads, std::max<std::size_t>(total, 1)));
+
+    // Blocks are small enough to balance the threads, and large enough to keep the shared counter quiet
+    const std::size_t block = std::max<std::size_t>(1, std::min<std::size_t>(64, total / (num_threads * 16)));
+
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::size_t> finished{0};
+    std::mutex failure_mutex;
+    std::exception_ptr failure;
+
+    const App &shared = app;
+    auto worker = [&]() {
+        try {
+            for(;;) {
+                std::size_t start = next.fetch_add(block);
+                if(start >= total)
+                    return;
+                std::size_t stop = std::min(start + block, total);
+                for(std::size_t i = start; i < stop; i++) {
+                    BatchItem item;
+                    item.index = i;
+                    detail::parse_batch_item(shared, *(std::begin(lines) + static_cast<std::ptrdiff_t>(i)), item);
+                    std::size_t slot = order == BatchOrder::Input ? i : finished.fetch_add(1);
+                    items[slot] = std::move(item);
+                }
+            }
+        } catch(...) {
+            std::lock_guard<std::mutex> lock(failure_mutex);
+            if(!failure)
+                failure = std::current_exception();
+            next = total;
+        }
+    };
+
+    // The calling thread does its share of the work too
+    std::vector<std::thread> threads;
+    for(unsigned t = 1; t < num_threads; t++)
+        threads.emplace_back(worker);
+    worker();
+    for(std::thread &thread : threads)
+        thread.join();
+
+    if(failure)
+        std::rethrow_exception(failure);
+
+    return items;
+}
+
+namespace detail {
+
+/// Classify arguments on a number of threads, each taking one contiguous block. Short lists are classified on the
+/// calling thread, where starting threads would cost more than it saves.
+inline TokenStream classify_parallel(std::size_t count, const char *const *args, unsigned num_threads) {
+    std::vector<Token> tokens(count);
+
+    if(num_threads == 0)
+        num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    const std::size_t min_block = 1 << 16;
+    num_threads =
+        static_cast<unsigned>(std::min<std::size_t>(num_threads, std::max<std::size_t>(count / min_block, 1)));
+
+    const std::size_t block = (count + num_threads - 1) / std::max(num_threads, 1u);
+    std::vector<std::thread> threads;
+    for(unsigned t = 1; t < num_threads; t++) {
+        std::size_t start = std::min(t * block, count);
+        std::size_t size = std::min(block, count - start);
+        threads.emplace_back(classify_all, args + start, size, tokens.data() + start);
+    }
+    classify_all(args, std::min(block, count), tokens.data());
+    for(std::thread &thread : threads)
+        thread.join();
+
+    return TokenStream(std::move(tokens));
+}
+
+} // namespace detail
+
+/// Parse one very long command line (such as a generated list of files), classifying the arguments on a number of
+/// threads first (0 uses all the hardware threads). The arguments are then bound in order on the calling thread, so
+/// the outcome is exactly that of `App::try_parse`.
+inline ParseStatus try_parse_parallel(App &app, int argc, const char *const *argv, unsigned num_threads = 0) {
+    detail::TokenStream tokens =
+        detail::classify_parallel(argc > 1 ? static_cast<std::size_t>(argc - 1) : 0, argv + 1, num_threads);
+    return app._try_parse(tokens, argv[0]);
+}
+
+/// Parse one very long command line like `try_parse_parallel`, throwing errors like `App::parse`
+inline void parse_parallel(App &app, int argc, const char *const *argv, unsigned num_threads = 0) {
+    try_parse_parallel(app, argc, argv, num_threads).raise();
+}
+
+} // namespace CLI
@@ -10,20 +10,39 @@
 
 #include "CLI/Macros.hpp"
 
-#include "CLI/Optional.hpp"
+#include "CLI/StringView.hpp"
 
 #include "CLI/StringTools.hpp"
 
 #include "CLI/Error.hpp"
 
+#include "CLI/ParseStatus.hpp"
+
 #include "CLI/TypeTools.hpp"
+#include "CLI/Optional.hpp"
 
 #include "CLI/Split.hpp"
 
+#include "CLI/NameIndex.hpp"
+
+#include "CLI/ResponseFile.hpp"
+
+#include "CLI/TokenStream.hpp"
+
+#include "CLI/OptionBits.hpp"
+
+#include "CLI/ResultArena.hpp"
+
 #include "CLI/Ini.hpp"
 
 #include "CLI/Validators.hpp"
 
 #include "CLI/Option.hpp"
 
+#include "CLI/Lazy.hpp"
+
+#include "CLI/ParseResult.hpp"
+
 #include "CLI/App.hpp"
+
+#include "CLI/PushParser.hpp"
@@ -3,6 +3,7 @@
 // Distributed under the 3-Clause BSD License.  See accompanying
 // file LICENSE or https://github.com/CLIUtils/CLI11 for details.
 
+#include <cstddef>
 #include <exception>
 #include <stdexcept>
 #include <string>
@@ -107,6 +108,15 @@ class IncorrectConstruction : public ConstructionError {
     static IncorrectConstruction MultiOptionPolicy(std::string name) {
         return IncorrectConstruction(name + ": multi_option_policy only works for flags and exact value options");
     }
+    static IncorrectConstruction ValueCheckType(std::string name) {
+        return IncorrectConstruction(name + ": check_value needs the type the option converts its values to");
+    }
+    static IncorrectConstruction Frozen(std::string name) {
+        return IncorrectConstruction("App " + name + " is frozen, options and subcommands cannot be changed");
+    }
+    static IncorrectConstruction NotFrozen(std::string name) {
+        return IncorrectConstruction("App " + name + " must be frozen to parse into a separate result");
+    }
 };
 
 /// Thrown on construction of a bad name
@@ -168,6 +178,7 @@ class FileError : public ParseError {
     CLI11_ERROR_DEF(ParseError, FileError)
     CLI11_ERROR_SIMPLE(FileError)
     static FileError Missing(std::string name) { return FileError(name + " was not readable (missing?)"); }
+    static FileError Recursive(std::string name) { return FileError("Response file " + name + " includes itself"); }
 };
 
 /// Thrown when conversion call back fails, such as when an int fails to coerce to a string
@@ -178,6 +189,9 @@ class ConversionError : public ParseError {
         : ConversionError("The value " + member + " is not an allowed value for " + name) {}
     ConversionError(std::string name, std::vector<std::string> results)
         : ConversionError("Could not convert: " + name + " = " + detail::join(results)) {}
+    static ConversionError At(std::string name, std::size_t index, std::string value) {
+        return ConversionError("Could not convert: " + name + "[" + std::to_string(index) + "] = " + value);
+    }
     static ConversionError TooManyInputsFlag(std::string name) {
         return ConversionError(name + ": too many inputs for a flag");
     }
@@ -0,0 +1,58 @@
+#pragma once
+
+// Distributed under the 3-Clause BSD License.  See accompanying
+// file LICENSE or https://github.com/CLIUtils/CLI11 for details.
+
+#include <utility>
+
+#include "CLI/Option.hpp"
+
+namespace CLI {
+
+/// A variable for an option that is only converted from the command line when it is first read.
+///
+/// Adding an option with a `Lazy<T>` makes the option lazy: the parse stores the text, and `get()` runs the conversion
+/// (and the validators) the first time it is called after a parse, keeping the value for later calls. Conversion errors
+/// are thrown from `get()`, or all at once from `App::convert_lazy()`.
+template <typename T> class Lazy {
+    friend App;
+
+    /// The converted value, set by the option callback
+    T value_;
+
+    /// The value when the option is not given
+    T default_;
+
+    /// The option that fills this, set by `App::add_option`
+    Option *option_{nullptr};
+
+  public:
+    Lazy() : value_(), default_() {}
+
+    /// Start with a value for when the option is not given
+    explicit Lazy(T default_value) : value_(default_value), default_(std::move(default_value)) {}
+
+    // The option callback refers to this object, so it cannot be copied
+    Lazy(const Lazy &) = delete;
+    Lazy &operator=(const Lazy &) = delete;
+
+    /// True if the option was given (nothing is converted)
+    bool given() const { return option_ != nullptr && option_->count() > 0; }
+
+    /// The value, converted now if this is the first read since the option got its values
+    const T &get() const {
+        if(!given())
+            return default_;
+        if(!option_->get_callback_run())
+            option_->run_callback();
+        return value_;
+    }
+
+    const T &operator*() const { return get(); }
+    const T *operator->() const { return &get(); }
+
+    /// The option that fills this (nullptr until it is added to an App)
+    Option *get_option() const { return option_; }
+};
+
+} // namespace CLI
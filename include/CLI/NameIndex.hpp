@@ -0,0 +1,358 @@
+#pragma once
+
+// Distributed under the 3-Clause BSD License.  See accompanying
+// file LICENSE or https://github.com/CLIUtils/CLI11 for details.
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace CLI {
+namespace detail {
+
+/// Fold the case of an ASCII letter; names are compared without the locale, so lookups never touch it
+inline char fold_char(char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; }
+
+/// Hash of a name (FNV-1a), after case folding if requested. Computed directly on the characters, no copy is made.
+inline std::size_t name_hash(const char *data, std::size_t size, bool fold) {
+    std::size_t hash = static_cast<std::size_t>(14695981039346656037ULL);
+    for(std::size_t i = 0; i < size; i++) {
+        hash ^= static_cast<unsigned char>(fold ? fold_char(data[i]) : data[i]);
+        hash *= static_cast<std::size_t>(1099511628211ULL);
+    }
+    return hash;
+}
+
+/// Compare two names, folding case if requested
+inline bool names_match(const char *data, std::size_t size, const std::string &name, bool ignore_case) {
+    if(size != name.size())
+        return false;
+    if(!ignore_case)
+        return name.compare(0, size, data, size) == 0;
+    for(std::size_t i = 0; i < size; i++)
+        if(fold_char(data[i]) != fold_char(name[i]))
+            return false;
+    return true;
+}
+
+/// Hash index from names to values, where each name can be case sensitive or not.
+///
+/// Once a case insensitive name is added, buckets are keyed on the hash of the folded name, so case sensitive and case
+/// insensitive entries share a single probe, and a lookup never needs to make a lower case copy of the query. Until
+/// then names are hashed as they are. Entries in a bucket keep insertion order.
+template <typename T> class NameIndex {
+    struct Entry {
+        std::string name;
+        bool ignore_case;
+        T value;
+    };
+
+    std::unordered_map<std::size_t, std::vector<Entry>> buckets_;
+
+    /// True if the buckets are keyed on folded names
+    bool fold_{false};
+
+    std::size_t hash(const char *data, std::size_t size) const { return name_hash(data, size, fold_); }
+
+  public:
+    /// Add a name for a value (duplicates are not checked here, see `conflict`)
+    void add(const std::string &name, bool ignore_case, T value) {
+        if(ignore_case && !fold_) {
+            // Key the existing entries on their folded names too
+            std::unordered_map<std::size_t, std::vector<Entry>> exact;
+            exact.swap(buckets_);
+            fold_ = true;
+            for(auto &bucket : exact)
+                for(Entry &entry : bucket.second)
+                    buckets_[hash(entry.name.data(), entry.name.size())].push_back(std::move(entry));
+        }
+        buckets_[hash(name.data(), name.size())].push_back(Entry{name, ignore_case, value});
+    }
+
+    /// Remove a name for a value
+    void remove(const std::string &name, T value) {
+        auto bucket = buckets_.find(hash(name.data(), name.size()));
+        if(bucket == buckets_.end())
+            return;
+        std::vector<Entry> &entries = bucket->second;
+        for(auto it = entries.begin(); it != entries.end(); ++it) {
+            if(it->value == value && it->name == name) {
+                entries.erase(it);
+                break;
+            }
+        }
+        if(entries.empty())
+            buckets_.erase(bucket);
+    }
+
+    /// Remove everything
+    void clear() {
+        buckets_.clear();
+        fold_ = false;
+    }
+
+    /// True if there are no names
+    bool empty() const { return buckets_.empty(); }
+
+    /// Find the first value (in insertion order) matching a name and a predicate, or a default value if none
+    template <typename Pred> T find_if(const char *data, std::size_t size, Pred pred) const {
+        auto bucket = buckets_.find(hash(data, size));
+        if(bucket != buckets_.end())
+            for(const Entry &entry : bucket->second)
+                if(names_match(data, size, entry.name, entry.ignore_case) && pred(entry.value))
+                    return entry.value;
+        return T{};
+    }
+
+    /// Find the first value matching a name, or a default value if none
+    T find(const char *data, std::size_t size) const {
+        return find_if(data, size, [](const T &) { return true; });
+    }
+
+    /// Find the first value matching a name, or a default value if none
+    T find(const std::string &name) const { return find(name.data(), name.size()); }
+
+    /// Find a value other than `self` that would clash with this name
+    ///
+    /// Two names clash if they are identical, or if they are equal after folding and either one ignores case.
+    T conflict(const std::string &name, bool ignore_case, T self) const {
+        auto clashes = [&](const Entry &entry) {
+            return entry.value != self &&
+                   names_match(name.data(), name.size(), entry.name, ignore_case || entry.ignore_case);
+        };
+        if(ignore_case && !fold_) {
+            // The buckets are keyed on exact names, so names that differ in case can be anywhere
+            for(const auto &bucket : buckets_)
+                for(const Entry &entry : bucket.second)
+                    if(clashes(entry))
+                        return entry.value;
+            return T{};
+        }
+        auto bucket = buckets_.find(hash(name.data(), name.size()));
+        if(bucket != buckets_.end())
+            for(const Entry &entry : bucket->second)
+                if(clashes(entry))
+                    return entry.value;
+        return T{};
+    }
+};
+
+/// Direct lookup table from single character names to values.
+///
+/// Case sensitive names are stored by character, case insensitive ones by folded character.
+template <typename T> class CharIndex {
+    std::array<T, 256> exact_;
+    std::array<T, 256> folded_;
+    std::size_t num_folded_{0};
+
+    static std::size_t key(char c) { return static_cast<unsigned char>(c); }
+
+  public:
+    CharIndex() {
+        exact_.fill(T{});
+        folded_.fill(T{});
+    }
+
+    /// Add a name for a value (only one value per character is kept, see `conflict`)
+    void add(char name, bool ignore_case, T value) {
+        if(ignore_case) {
+            folded_[key(fold_char(name))] = value;
+            num_folded_++;
+        } else
+            exact_[key(name)] = value;
+    }
+
+    /// Remove a name for a value
+    void remove(char name, T value) {
+        if(exact_[key(name)] == value)
+            exact_[key(name)] = T{};
+        T &slot = folded_[key(fold_char(name))];
+        if(slot == value) {
+            slot = T{};
+            num_folded_--;
+        }
+    }
+
+    /// Remove everything
+    void clear() {
+        exact_.fill(T{});
+        folded_.fill(T{});
+        num_folded_ = 0;
+    }
+
+    /// Find the value for a character, or a default value if none
+    T find(char name) const {
+        T value = exact_[key(name)];
+        if(value == T{} && num_folded_ > 0)
+            value = folded_[key(fold_char(name))];
+        return value;
+    }
+
+    /// Find a value other than `self` that would clash with this name
+    T conflict(char name, bool ignore_case, T self) const {
+        char folded = fold_char(name);
+        T other = folded_[key(folded)];
+        if(other != T{} && other != self)
+            return other;
+        if(!ignore_case) {
+            other = exact_[key(name)];
+            return other != self ? other : T{};
+        }
+        for(std::size_t c = 0; c < exact_.size(); c++) {
+            other = exact_[c];
+            if(other != T{} && other != self && fold_char(static_cast<char>(c)) == folded)
+                return other;
+        }
+        return T{};
+    }
+};
+
+
+/// Radix trie over names, to find the one value whose names start with a prefix (for abbreviated long options).
+///
+/// Each node keeps the value of all the names below it, or notes that there is more than one, so a lookup walks the
+/// prefix once and needs nothing else. Case sensitive names and folded case insensitive names have their own roots.
+template <typename T> class PrefixTrie {
+    struct Node {
+        /// The characters on the edge into this node
+        std::string label;
+
+        /// Indexes of the child nodes, sorted by the first character of their label
+        std::vector<std::size_t> children;
+
+        /// The value of every name at or below this node, if there is only one
+        T value{};
+
+        /// True if the names below have different values
+        bool shared{false};
+    };
+
+    /// The nodes, 0 is the root of the case sensitive names and 1 the root of the folded names
+    std::vector<Node> nodes_;
+
+    enum : std::size_t { npos = static_cast<std::size_t>(-1) };
+
+    /// The child of a node whose label starts with a character, or npos
+    std::size_t child(std::size_t node, char c) const {
+        const std::vector<std::size_t> &children = nodes_[node].children;
+        auto it = std::lower_bound(children.begin(), children.end(), c, [this](std::size_t n, char key) {
+            return nodes_[n].label[0] < key;
+        });
+        return it != children.end() && nodes_[*it].label[0] == c ? *it : npos;
+    }
+
+    /// Add a child to a node, keeping the children sorted
+    void attach(std::size_t node, std::size_t added) {
+        char c = nodes_[added].label[0];
+        std::vector<std::size_t> &children = nodes_[node].children;
+        auto it = std::lower_bound(children.begin(), children.end(), c, [this](std::size_t n, char key) {
+            return nodes_[n].label[0] < key;
+        });
+        children.insert(it, added);
+    }
+
+    /// Note that a value has a name at or below a node
+    void mark(std::size_t node, T value) {
+        Node &n = nodes_[node];
+        if(n.value == T{})
+            n.value = value;
+        else if(n.value != value)
+            n.shared = true;
+    }
+
+    /// Add a name below one of the roots
+    void insert(std::size_t node, const std::string &name, T value) {
+        mark(node, value);
+        std::size_t pos = 0;
+        while(pos < name.size()) {
+            std::size_t next = child(node, name[pos]);
+            if(next == npos) {
+                Node leaf;
+                leaf.label = name.substr(pos);
+                leaf.value = value;
+                nodes_.push_back(leaf);
+                attach(node, nodes_.size() - 1);
+                return;
+            }
+
+            // Split the edge where the name leaves it
+            const std::string &label = nodes_[next].label;
+            std::size_t common = 1;
+            while(common < label.size() && pos + common < name.size() && label[common] == name[pos + common])
+                common++;
+            if(common < label.size()) {
+                Node tail = nodes_[next];
+                tail.label = label.substr(common);
+                nodes_.push_back(tail);
+                nodes_[next].label.resize(common);
+                nodes_[next].children.assign(1, nodes_.size() - 1);
+            }
+
+            mark(next, value);
+            node = next;
+            pos += common;
+        }
+    }
+
+    /// Walk a prefix down from a root; the node it ends in, or npos
+    std::size_t walk(std::size_t node, const char *data, std::size_t size, bool fold) const {
+        std::size_t pos = 0;
+        while(pos < size) {
+            node = child(node, fold ? fold_char(data[pos]) : data[pos]);
+            if(node == npos)
+                return npos;
+            const std::string &label = nodes_[node].label;
+            std::size_t length = std::min(label.size(), size - pos);
+            for(std::size_t i = 1; i < length; i++)
+                if((fold ? fold_char(data[pos + i]) : data[pos + i]) != label[i])
+                    return npos;
+            pos += length;
+        }
+        return node;
+    }
+
+  public:
+    PrefixTrie() : nodes_(2) {}
+
+    /// Add a name for a value
+    void add(const std::string &name, bool ignore_case, T value) {
+        if(name.empty())
+            return;
+        if(ignore_case) {
+            std::string folded = name;
+            for(char &c : folded)
+                c = fold_char(c);
+            insert(1, folded, value);
+        } else
+            insert(0, name, value);
+    }
+
+    /// Remove everything
+    void clear() { nodes_.assign(2, Node()); }
+
+    /// Find the only value with a name starting with the prefix. Returns a default value if there is none, or if there
+    /// is more than one (then `ambiguous` is set).
+    T find(const char *data, std::size_t size, bool &ambiguous) const {
+        ambiguous = false;
+        T found{};
+        for(std::size_t root = 0; root < 2; root++) {
+            if(nodes_[root].value == T{})
+                continue;
+            std::size_t node = walk(root, data, size, root == 1);
+            if(node == npos)
+                continue;
+            if(nodes_[node].shared || (found != T{} && found != nodes_[node].value)) {
+                ambiguous = true;
+                return T{};
+            }
+            found = nodes_[node].value;
+        }
+        return found;
+    }
+};
+
+} // namespace detail
+} // namespace CLI
@@ -14,14 +14,21 @@
 
 #include "CLI/Error.hpp"
 #include "CLI/Macros.hpp"
+#include "CLI/OptionBits.hpp"
+#include "CLI/ParseStatus.hpp"
+#include "CLI/ResultArena.hpp"
 #include "CLI/Split.hpp"
 #include "CLI/StringTools.hpp"
+#include "CLI/Validators.hpp"
 
 namespace CLI {
 
 using results_t = std::vector<std::string>;
 using callback_t = std::function<bool(results_t)>;
 
+/// Option callback that reads the stored results in place
+using view_callback_t = std::function<bool(const ResultsView &)>;
+
 class Option;
 class App;
 
@@ -191,12 +198,27 @@ class Option : public OptionBase<Option> {
     /// A list of validators to run on each value parsed
     std::vector<std::function<std::string(std::string &)>> validators_;
 
+    /// The type `App::add_option` converts the values to, or nullptr if it is not known (see `check_value`)
+    const void *value_type_{nullptr};
+
+    /// The checks of the converted values, made by the first `check_value`
+    std::unique_ptr<detail::ValueChecksBase> value_checks_;
+
     /// A list of options that are required with this option
     std::set<Option *> requires_;
 
     /// A list of options that are excluded with this option
     std::set<Option *> excludes_;
 
+    /// The ids of requires_ in the same App. Built by App::_validate.
+    detail::OptionBits needs_bits_;
+
+    /// The ids of excludes_ in the same App. Built by App::_validate.
+    detail::OptionBits excludes_bits_;
+
+    /// True if requires_ or excludes_ has an option of another App, which has to be checked by pointer
+    bool outside_constraints_{false};
+
     ///@}
     /// @name Other
     ///@{
@@ -204,25 +226,40 @@ class Option : public OptionBase<Option> {
     /// Remember the parent app
     App *parent_;
 
+    /// The position of this option in its App, set by the App when it is added
+    std::size_t id_{0};
+
     /// Options store a callback to do all the work
-    callback_t callback_;
+    view_callback_t callback_;
 
     ///@}
     /// @name Parsing results
     ///@{
 
-    /// Results of parsing
-    results_t results_;
+    /// Results of parsing, as spans into the arena of the parent App
+    std::vector<detail::ResultSpan> results_;
 
-    /// Whether the callback has run (needed for INI parsing)
+    /// Storage for the text of the results, set by the App that makes this option
+    detail::ResultArena *arena_{nullptr};
+
+    /// Whether the callback has run on the current results (needed for INI parsing and lazy options)
     bool callback_run_{false};
 
+    /// If true, the callback is not run by the parse, but when the value is first read (see `CLI::Lazy`)
+    bool lazy_{false};
+
+    /// If true, the parse stops as soon as this option is given
+    bool short_circuit_{false};
+
+    /// Each value is split into several on this character ('\0' for none)
+    char delimiter_{'\0'};
+
     ///@}
 
     /// Making an option by hand is not defined, it must be made by the App class
     Option(std::string name,
            std::string description = "",
-           std::function<bool(results_t)> callback = [](results_t) { return true; },
+           view_callback_t callback = [](const ResultsView &) { return true; },
            bool default_ = true,
            App *parent = nullptr)
         : description_(std::move(description)), default_(default_), parent_(parent), callback_(std::move(callback)) {
@@ -239,15 +276,30 @@ class Option : public OptionBase<Option> {
     /// This class is true if option is passed.
     operator bool() const { return count() > 0; }
 
-    /// Clear the parsed results (mostly for testing)
-    void clear() { results_.clear(); }
+    /// Clear the parsed results (mostly for testing). The text is released before the next parse, or by `App::reset`.
+    void clear() {
+        results_.clear();
+        _update_given();
+    }
 
     ///@}
     /// @name Setting options
     ///@{
 
+    /// Set the option as required (not after the App is frozen, the required options are part of its tables)
+    Option *required(bool value = true) {
+        _check_not_frozen();
+        required_ = value;
+        return this;
+    }
+
+    /// Support Plumbum term
+    Option *mandatory(bool value = true) { return required(value); }
+
     /// Set the number of expected arguments (Flags don't use this)
     Option *expected(int value) {
+        _check_not_frozen();
+
         // Break if this is a flag
         if(type_size_ == 0)
             throw IncorrectConstruction::SetFlag(single_name());
@@ -278,6 +330,19 @@ class Option : public OptionBase<Option> {
         return this;
     }
 
+    /// Adds a check of the converted value, such as `check_value<int>(CLI::Range(0, 100))`. The check takes a
+    /// `const T &` and returns an error message (empty if the value is fine); it runs once over all the values after
+    /// they are converted, so nothing is converted twice. T is the type the option converts to (the element type for a
+    /// vector).
+    template <typename T, typename Check> Option *check_value(Check check) {
+        if(value_type_ != detail::type_tag<T>())
+            throw IncorrectConstruction::ValueCheckType(get_name());
+        if(value_checks_ == nullptr)
+            value_checks_.reset(new detail::ValueChecks<T>());
+        static_cast<detail::ValueChecks<T> *>(value_checks_.get())->add(std::move(check));
+        return this;
+    }
+
     /// Adds a validator-like function that can change result
     Option *transform(std::function<std::string(std::string)> func) {
         validators_.emplace_back([func](std::string &inout) {
@@ -293,6 +358,7 @@ class Option : public OptionBase<Option> {
 
     /// Sets required options
     Option *needs(Option *opt) {
+        _check_not_frozen();
         auto tup = requires_.insert(opt);
         if(!tup.second)
             throw OptionAlreadyAdded::Requires(single_name(), opt->single_name());
@@ -301,10 +367,10 @@ class Option : public OptionBase<Option> {
 
     /// Can find a string if needed
     template <typename T = App> Option *needs(std::string opt_name) {
-        for(const Option_p &opt : dynamic_cast<T *>(parent_)->options_)
-            if(opt.get() != this && opt->check_name(opt_name))
-                return needs(opt.get());
-        throw IncorrectConstruction::MissingOption(opt_name);
+        Option *opt = dynamic_cast<T *>(parent_)->_find_option(opt_name, this);
+        if(opt == nullptr)
+            throw IncorrectConstruction::MissingOption(opt_name);
+        return needs(opt);
     }
 
     /// Any number supported, any mix of string and Opt
@@ -320,10 +386,7 @@ class Option : public OptionBase<Option> {
 
     /// Can find a string if needed \deprecated
     template <typename T = App> Option *requires(std::string opt_name) {
-        for(const Option_p &opt : dynamic_cast<T *>(parent_)->options_)
-            if(opt.get() != this && opt->check_name(opt_name))
-                return needs(opt.get());
-        throw IncorrectConstruction::MissingOption(opt_name);
+        return needs<T>(opt_name);
     }
 
     /// Any number supported, any mix of string and Opt \deprecated
@@ -335,6 +398,8 @@ class Option : public OptionBase<Option> {
 
     /// Sets excluded options
     Option *excludes(Option *opt) {
+        _check_not_frozen();
+        opt->_check_not_frozen();
         excludes_.insert(opt);
 
         // Help text should be symmetric - excluding a should exclude b
@@ -348,10 +413,10 @@ class Option : public OptionBase<Option> {
 
     /// Can find a string if needed
     template <typename T = App> Option *excludes(std::string opt_name) {
-        for(const Option_p &opt : dynamic_cast<T *>(parent_)->options_)
-            if(opt.get() != this && opt->check_name(opt_name))
-                return excludes(opt.get());
-        throw IncorrectConstruction::MissingOption(opt_name);
+        Option *opt = dynamic_cast<T *>(parent_)->_find_option(opt_name, this);
+        if(opt == nullptr)
+            throw IncorrectConstruction::MissingOption(opt_name);
+        return excludes(opt);
     }
 
     /// Any number supported, any mix of string and Opt
@@ -362,6 +427,7 @@ class Option : public OptionBase<Option> {
 
     /// Sets environment variable to read if no option given
     Option *envname(std::string name) {
+        _check_not_frozen();
         envname_ = name;
         return this;
     }
@@ -371,16 +437,44 @@ class Option : public OptionBase<Option> {
     /// The template hides the fact that we don't have the definition of App yet.
     /// You are never expected to add an argument to the template here.
     template <typename T = App> Option *ignore_case(bool value = true) {
-        ignore_case_ = value;
         auto *parent = dynamic_cast<T *>(parent_);
+        parent->_check_not_frozen();
+
+        // The names are indexed with their case setting, so they need to be refreshed
+        parent->_unindex_option(this);
+        ignore_case_ = value;
+        parent->_index_option(this);
 
-        for(const Option_p &opt : parent->options_)
-            if(opt.get() != this && *opt == *this)
-                throw OptionAlreadyAdded(opt->get_name());
+        if(Option *other = parent->_find_conflict(this))
+            throw OptionAlreadyAdded(other->get_name());
 
         return this;
     }
 
+    /// Keep the values as text after parsing, and only convert them when they are first read
+    Option *lazy(bool value = true) {
+        _check_not_frozen();
+        lazy_ = value;
+        return this;
+    }
+
+    /// Stop the parse as soon as this option is given (with its values): the arguments after it are not read, and the
+    /// config file, environment, requirements and other callbacks are skipped. A help flag ends the parse with
+    /// CallForHelp, any other option runs its own callback.
+    Option *short_circuit(bool value = true) {
+        _check_not_frozen();
+        short_circuit_ = value;
+        return this;
+    }
+
+    /// Split every value on a character, so `--ids 1,2,3` gives three values (from the command line, a config file or
+    /// the environment alike). The pieces are found in the stored copy of the value; '\0' turns this off.
+    Option *delimiter(char value = '\0') {
+        _check_not_frozen();
+        delimiter_ = value;
+        return this;
+    }
+
     /// Take the last argument if given multiple times (or another policy)
     Option *multi_option_policy(MultiOptionPolicy value = MultiOptionPolicy::Throw) {
 
@@ -424,6 +518,18 @@ class Option : public OptionBase<Option> {
     /// True if this has a default value
     int get_default() const { return default_; }
 
+    /// The dense id of this option in its App (its position in the options, in the order they were added)
+    std::size_t get_id() const { return id_; }
+
+    /// True if the callback waits until the value is read
+    bool get_lazy() const { return lazy_; }
+
+    /// True if the parse stops at this option
+    bool get_short_circuit() const { return short_circuit_; }
+
+    /// The character values are split on ('\0' for none)
+    char get_delimiter() const { return delimiter_; }
+
     /// True if the argument can be given directly
     bool get_positional() const { return pname_.length() > 0; }
 
@@ -525,50 +631,83 @@ class Option : public OptionBase<Option> {
     /// @name Parser tools
     ///@{
 
-    /// Process the callback
+    /// Process the callback, throws the error if there is one
     void run_callback() {
+        ParseStatus status;
+        if(!run_callback(status))
+            status.raise();
+    }
+
+    /// Process the callback, returns false (with the error in the status) on failure
+    bool run_callback(ParseStatus &status) {
 
-        // Run the validators (can change the string)
+        // Run the validators (can change the string, a changed value is stored again)
         if(!validators_.empty()) {
-            for(std::string &result : results_)
+            for(detail::ResultSpan &span : results_) {
+                std::string result = arena_->str(span);
                 for(const std::function<std::string(std::string &)> &vali : validators_) {
                     std::string err_msg = vali(result);
-                    if(!err_msg.empty())
-                        throw ValidationError(single_name(), err_msg);
+                    if(!err_msg.empty()) {
+                        status = ParseStatus(ParseStatus::Kind::Validation, single_name(), err_msg);
+                        return false;
+                    }
                 }
+                if(arena_->view(span) != string_view(result))
+                    arena_->replace(span, result);
+            }
         }
 
-        bool local_result;
-
         // Num items expected or length of vector, always at least 1
         // Only valid for a trimming policy
         int trim_size = std::min(std::max(std::abs(get_items_expected()), 1), static_cast<int>(results_.size()));
-
-        // Operation depends on the policy setting
+        const detail::ResultSpan *first = results_.data();
+        const detail::ResultSpan *last = results_.data() + results_.size();
+        detail::ResultArena joined;
+        detail::ResultSpan partial_result;
+
+        // Operation depends on the policy setting, the callback sees the stored results in place
+        if(value_checks_ != nullptr)
+            value_checks_->error.clear();
+        ResultsView view(arena_, first, last);
         if(multi_option_policy_ == MultiOptionPolicy::TakeLast) {
             // Allow multi-option sizes (including 0)
-            results_t partial_result{results_.end() - trim_size, results_.end()};
-            local_result = !callback_(partial_result);
+            view = ResultsView(arena_, last - trim_size, last);
 
         } else if(multi_option_policy_ == MultiOptionPolicy::TakeFirst) {
-            results_t partial_result{results_.begin(), results_.begin() + trim_size};
-            local_result = !callback_(partial_result);
+            view = ResultsView(arena_, first, first + trim_size);
 
         } else if(multi_option_policy_ == MultiOptionPolicy::Join) {
-            results_t partial_result = {detail::join(results_, "\n")};
-            local_result = !callback_(partial_result);
+            // The joined value only lives for the callback, so it is kept out of the arena of the App
+            for(const detail::ResultSpan &span : results_) {
+                if(&span != first)
+                    joined.add("\n");
+                joined.add(arena_->view(span));
+            }
+            partial_result = detail::ResultSpan{0, joined.size()};
+            view = ResultsView(&joined, &partial_result, &partial_result + 1);
 
         } else {
             // For now, vector of non size 1 types are not supported but possibility included here
             if((get_items_expected() > 0 && results_.size() != static_cast<size_t>(get_items_expected())) ||
-               (get_items_expected() < 0 && results_.size() < static_cast<size_t>(-get_items_expected())))
-                throw ArgumentMismatch(single_name(), get_items_expected(), results_.size());
-            else
-                local_result = !callback_(results_);
+               (get_items_expected() < 0 && results_.size() < static_cast<size_t>(-get_items_expected()))) {
+                status = ParseStatus(
+                    ParseStatus::Kind::ArgumentMismatch, single_name(), "", get_items_expected(), results_.size());
+                return false;
+            }
         }
 
-        if(local_result)
-            throw ConversionError(get_name(), results_);
+        if(!callback_(view)) {
+            std::size_t failed = view.failed_at();
+            if(value_checks_ != nullptr && !value_checks_->error.empty())
+                status = ParseStatus(ParseStatus::Kind::Validation, single_name(), value_checks_->error);
+            else if(failed < view.size())
+                status = ParseStatus(ParseStatus::Kind::ConversionAt, get_name(), std::string(view[failed]), 0, failed);
+            else
+                status = ParseStatus(ParseStatus::Kind::Conversion, get_name(), "", 0, 0, results());
+            return false;
+        }
+        callback_run_ = true;
+        return true;
     }
 
     /// If options share any of the same names, they are equal (not counting positional)
@@ -628,14 +767,23 @@ class Option : public OptionBase<Option> {
             return std::find(std::begin(lnames_), std::end(lnames_), name) != std::end(lnames_);
     }
 
-    /// Puts a result at the end, unless last_ is set, in which case it just keeps the last one
-    void add_result(std::string s) {
-        results_.push_back(s);
+    /// Throw if the parent App is frozen (defined after App)
+    void _check_not_frozen() const;
+
+    /// Mark this option as given in the parent App, or not, to match its results (defined after App)
+    void _update_given();
+
+    /// Puts a result at the end, or one for each delimited piece (the text is copied into the arena of the parent App)
+    void add_result(string_view s) {
+        detail::add_split(*arena_, s, delimiter_, results_);
         callback_run_ = false;
+        _update_given();
     }
 
     /// Get a copy of the results
-    std::vector<std::string> results() const { return results_; }
+    std::vector<std::string> results() const {
+        return arena_->strs(results_.data(), results_.data() + results_.size());
+    }
 
     /// See if the callback has been run already
     bool get_callback_run() const { return callback_run_; }
@@ -660,10 +808,14 @@ class Option : public OptionBase<Option> {
     /// Set the default value string representation and evaluate
     void set_default_val(std::string val) {
         set_default_str(val);
-        auto old_results = results_;
-        results_ = {val};
+        std::vector<detail::ResultSpan> old_results;
+        std::swap(old_results, results_);
+        bool old_callback_run = callback_run_;
+        add_result(val);
         run_callback();
         results_ = std::move(old_results);
+        callback_run_ = old_callback_run;
+        _update_given();
     }
 
     /// Set the type name displayed on this option
@@ -681,6 +833,12 @@ class Option : public OptionBase<Option> {
     bool _has_help_positional() const {
         return get_positional() && (has_description() || !requires_.empty() || !excludes_.empty());
     }
+
+    /// Run the checks of the converted values, returns false if one fails (called by the `App::add_option` callbacks)
+    template <typename T> bool _check_values(const T *values, std::size_t count) {
+        return value_checks_ == nullptr ||
+               static_cast<detail::ValueChecks<T> *>(value_checks_.get())->run(values, count);
+    }
     ///@}
 };
 
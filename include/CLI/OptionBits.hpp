@@ -0,0 +1,118 @@
+#pragma once
+
+// Distributed under the 3-Clause BSD License.  See accompanying
+// file LICENSE or https://github.com/CLIUtils/CLI11 for details.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace CLI {
+namespace detail {
+
+/// Index of the lowest set bit of a non-zero word
+inline std::size_t lowest_bit(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::size_t>(__builtin_ctzll(word));
+#else
+    std::size_t bit = 0;
+    while((word & 1u) == 0) {
+        word >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+/// A set of option ids (see `Option::get_id`), 64 to a word, so constraints between options are checked a word at a
+/// time. Sets of different sizes can be combined; missing words are zero.
+class OptionBits {
+    std::vector<std::uint64_t> words_;
+
+    /// A word, or zero past the end
+    std::uint64_t word(std::size_t i) const { return i < words_.size() ? words_[i] : 0; }
+
+    /// The first set bit of a combination of the words of two sets, starting at a bit, or npos
+    template <typename Combine>
+    std::size_t find_first(const OptionBits &other, std::size_t from, Combine combine) const {
+        for(std::size_t i = from / 64; i < words_.size(); i++) {
+            std::uint64_t bits = combine(words_[i], other.word(i));
+            if(i == from / 64)
+                bits &= ~std::uint64_t(0) << (from % 64);
+            if(bits != 0)
+                return i * 64 + lowest_bit(bits);
+        }
+        return npos;
+    }
+
+  public:
+    /// Returned by the searches when there is no match
+    enum : std::size_t { npos = static_cast<std::size_t>(-1) };
+
+    OptionBits() = default;
+
+    /// Make an empty set with room for this many ids
+    explicit OptionBits(std::size_t size) : words_((size + 63) / 64, 0) {}
+
+    /// Add an id (the set grows if needed)
+    void set(std::size_t id) {
+        if(id / 64 >= words_.size())
+            words_.resize(id / 64 + 1, 0);
+        words_[id / 64] |= std::uint64_t(1) << (id % 64);
+    }
+
+    /// Remove an id
+    void reset(std::size_t id) {
+        if(id / 64 < words_.size())
+            words_[id / 64] &= ~(std::uint64_t(1) << (id % 64));
+    }
+
+    /// Check for an id
+    bool test(std::size_t id) const { return (word(id / 64) >> (id % 64) & 1u) != 0; }
+
+    /// Add all the ids of another set
+    void add(const OptionBits &other) {
+        if(other.words_.size() > words_.size())
+            words_.resize(other.words_.size(), 0);
+        for(std::size_t i = 0; i < other.words_.size(); i++)
+            words_[i] |= other.words_[i];
+    }
+
+    /// Remove all the ids of another set
+    void remove(const OptionBits &other) {
+        for(std::size_t i = 0; i < words_.size(); i++)
+            words_[i] &= ~other.word(i);
+    }
+
+    /// Remove all the ids, keeping the storage
+    void clear() {
+        for(std::uint64_t &w : words_)
+            w = 0;
+    }
+
+    /// True if no id is set
+    bool none() const {
+        for(std::uint64_t w : words_)
+            if(w != 0)
+                return false;
+        return true;
+    }
+
+    /// The first id at or after `from`, or npos
+    std::size_t find_next(std::size_t from = 0) const {
+        return find_first(*this, from, [](std::uint64_t a, std::uint64_t) { return a; });
+    }
+
+    /// The first id (at or after `from`) that is in both sets, or npos
+    std::size_t first_and(const OptionBits &other, std::size_t from = 0) const {
+        return find_first(other, from, [](std::uint64_t a, std::uint64_t b) { return a & b; });
+    }
+
+    /// The first id (at or after `from`) that is in this set but not the other, or npos
+    std::size_t first_andn(const OptionBits &other, std::size_t from = 0) const {
+        return find_first(other, from, [](std::uint64_t a, std::uint64_t b) { return a & ~b; });
+    }
+};
+
+} // namespace detail
+} // namespace CLI
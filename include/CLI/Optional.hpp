@@ -4,8 +4,11 @@
 // file LICENSE or https://github.com/CLIUtils/CLI11 for details.
 
 #include <istream>
+#include <utility>
 
 #include "CLI/Macros.hpp"
+#include "CLI/StringView.hpp"
+#include "CLI/TypeTools.hpp"
 
 // [CLI11:verbatim]
 #ifdef __has_include
@@ -49,6 +52,17 @@ template <typename T> std::istream &operator>>(std::istream &in, std::optional<T
     val = v;
     return in;
 }
+
+/// An optional is read as the type it holds
+template <typename T> struct parser<std::optional<T>> {
+    static bool parse(string_view input, std::optional<T> &output) {
+        T value{};
+        if(!detail::lexical_cast(input, value))
+            return false;
+        output = std::move(value);
+        return true;
+    }
+};
 #endif
 
 #ifdef CLI11_EXPERIMENTAL_OPTIONAL
@@ -58,6 +72,16 @@ template <typename T> std::istream &operator>>(std::istream &in, std::experiment
     val = v;
     return in;
 }
+
+template <typename T> struct parser<std::experimental::optional<T>> {
+    static bool parse(string_view input, std::experimental::optional<T> &output) {
+        T value{};
+        if(!detail::lexical_cast(input, value))
+            return false;
+        output = std::move(value);
+        return true;
+    }
+};
 #endif
 
 #ifdef CLI11_BOOST_OPTIONAL
@@ -67,6 +91,16 @@ template <typename T> std::istream &operator>>(std::istream &in, boost::optional
     val = v;
     return in;
 }
+
+template <typename T> struct parser<boost::optional<T>> {
+    static bool parse(string_view input, boost::optional<T> &output) {
+        T value{};
+        if(!detail::lexical_cast(input, value))
+            return false;
+        output = std::move(value);
+        return true;
+    }
+};
 #endif
 
 // Export the best optional to the CLI namespace
@@ -0,0 +1,151 @@
+#pragma once
+
+// Distributed under the 3-Clause BSD License.  See accompanying
+// file LICENSE or https://github.com/CLIUtils/CLI11 for details.
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "CLI/OptionBits.hpp"
+#include "CLI/ParseStatus.hpp"
+#include "CLI/ResultArena.hpp"
+#include "CLI/StringView.hpp"
+#include "CLI/TokenStream.hpp"
+
+namespace CLI {
+
+class App;
+class Option;
+
+namespace detail {
+
+/// How far the positionals of an App have been filled: the next one to try, and how many of the ones with a fixed
+/// number of values (and of those, the required ones) are still short
+struct PositionalCursor {
+    std::size_t next{0};
+    std::size_t unfilled{0};
+    std::size_t required_unfilled{0};
+};
+
+} // namespace detail
+
+/// Everything a call to `App::parse_result` found, kept apart from the App.
+///
+/// A normal parse stores its results in the App and its options; this holds the same information instead, so a frozen
+/// App can parse many command lines at the same time. Option and App callbacks are not run, so the values are the
+/// strings as given (or as read from the config file and environment).
+class ParseResult {
+    friend App;
+
+    using missing_t = std::vector<std::pair<detail::Classifer, std::string>>;
+
+    /// What a parse records for one App (the same things App keeps in its parsing members)
+    struct AppState {
+        bool parsed{false};
+        missing_t missing;
+        std::vector<Option *> parse_order;
+        std::vector<App *> subcommands;
+        detail::PositionalCursor positionals;
+        detail::OptionBits given;
+    };
+
+    /// The App that was parsed
+    const App *app_;
+
+    /// Storage for the text of all the values
+    detail::ResultArena arena_;
+
+    /// Values of each option that was given, as spans into the arena
+    std::unordered_map<const Option *, std::vector<detail::ResultSpan>> results_;
+
+    /// The state of each App that was reached
+    std::unordered_map<const App *, AppState> apps_;
+
+    /// Why the parse failed, if it did
+    ParseStatus status_;
+
+    explicit ParseResult(const App *app) : app_(app) {}
+
+    /// Get (or start) the state of an App
+    AppState &state(const App *app) { return apps_[app]; }
+
+    /// Get the state of an App, or nullptr if it was not reached
+    const AppState *find_state(const App *app) const {
+        auto it = apps_.find(app);
+        return it == apps_.end() ? nullptr : &it->second;
+    }
+
+    /// Store a value for an option (split on the delimiter unless it is '\0'), returning the number of values it had
+    std::size_t add_result(const Option *opt, string_view value, char delimiter) {
+        std::vector<detail::ResultSpan> &spans = results_[opt];
+        std::size_t before = spans.size();
+        detail::add_split(arena_, value, delimiter, spans);
+        return before;
+    }
+
+  public:
+    /// The App that was parsed
+    const App *get_app() const { return app_; }
+
+    /// Success, or the error that stopped the parse (see `App::try_parse_result`)
+    const ParseStatus &get_status() const { return status_; }
+
+    /// Count the number of times an option was passed
+    std::size_t count(const Option *opt) const {
+        auto it = results_.find(opt);
+        return it == results_.end() ? 0 : it->second.size();
+    }
+
+    /// Get a copy of the values of an option
+    std::vector<std::string> results(const Option *opt) const { return results_view(opt).strs(); }
+
+    /// View the values of an option without copying them (valid as long as this result is)
+    ResultsView results_view(const Option *opt) const {
+        auto it = results_.find(opt);
+        if(it == results_.end())
+            return ResultsView(&arena_, nullptr, nullptr);
+        return ResultsView(&arena_, it->second.data(), it->second.data() + it->second.size());
+    }
+
+    /// Check to see if a subcommand was given
+    bool got_subcommand(const App *subcom) const {
+        const AppState *found = find_state(subcom);
+        return found != nullptr && found->parsed;
+    }
+
+    /// The subcommands given to an App (the parsed App by default), in command line order
+    std::vector<App *> get_subcommands(const App *app = nullptr) const {
+        const AppState *found = find_state(app == nullptr ? app_ : app);
+        return found == nullptr ? std::vector<App *>() : found->subcommands;
+    }
+
+    /// The options of an App (the parsed App by default) in the order they were parsed (including duplicates)
+    std::vector<Option *> parse_order(const App *app = nullptr) const {
+        const AppState *found = find_state(app == nullptr ? app_ : app);
+        return found == nullptr ? std::vector<Option *>() : found->parse_order;
+    }
+
+    /// The arguments that were not used by an App (the parsed App by default), optionally with its subcommands
+    std::vector<std::string> remaining(bool recurse = false, const App *app = nullptr) const {
+        std::vector<std::string> miss_list;
+        const AppState *found = find_state(app == nullptr ? app_ : app);
+        if(found == nullptr)
+            return miss_list;
+        for(const std::pair<detail::Classifer, std::string> &miss : found->missing)
+            miss_list.push_back(miss.second);
+
+        // Recurse into subcommands
+        if(recurse) {
+            for(const App *sub : found->subcommands) {
+                std::vector<std::string> output = remaining(recurse, sub);
+                miss_list.insert(miss_list.end(), output.begin(), output.end());
+            }
+        }
+        return miss_list;
+    }
+};
+
+} // namespace CLI
@@ -0,0 +1,193 @@
+#pragma once
+
+// Distributed under the 3-Clause BSD License.  See accompanying
+// file LICENSE or https://github.com/CLIUtils/CLI11 for details.
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "CLI/Error.hpp"
+
+namespace CLI {
+
+/// The outcome of a parse, as returned by `App::try_parse` instead of throwing.
+///
+/// A failure only keeps the kind of error and its parts (names, counts and values); the message is put together, and
+/// the matching `CLI::Error` made, when it is asked for. The throwing parse finds the same status and throws it with
+/// `raise`, so both report exactly the same errors.
+class ParseStatus {
+  public:
+    /// What went wrong, named after the error (and factory) it stands for
+    enum class Kind {
+        Success,
+        CallForHelp,
+        FileMissing,
+        FileRecursive,
+        Conversion,
+        ConversionAt,
+        ConversionTooManyInputsFlag,
+        ConversionTrueFalse,
+        Validation,
+        Required,
+        RequiredSubcommand,
+        ArgumentMismatch,
+        ArgumentMismatchAtLeast,
+        ArgumentMismatchTypedAtLeast,
+        Requires,
+        Excludes,
+        Extras,
+        INIExtras,
+        ININotConfigurable,
+        Horrible
+    };
+
+  private:
+    Kind kind_{Kind::Success};
+
+    /// The option or item the error is about (the whole message for Horrible)
+    std::string name_;
+
+    /// The other option, the type name, the validation message or the value that could not be converted
+    std::string other_;
+
+    /// The number of values expected, or of subcommands required
+    int number_{0};
+
+    /// The number of values received, or the index of the value that could not be converted
+    std::size_t count_{0};
+
+    /// The values that could not be converted, or the extra arguments
+    std::vector<std::string> items_;
+
+    /// Throws the error it is given (with its real type)
+    struct Raiser {
+        template <typename E> void operator()(const E &e) const { throw e; }
+    };
+
+  public:
+    ParseStatus() = default;
+
+    explicit ParseStatus(Kind kind,
+                         std::string name = "",
+                         std::string other = "",
+                         int number = 0,
+                         std::size_t count = 0,
+                         std::vector<std::string> items = {})
+        : kind_(kind), name_(std::move(name)), other_(std::move(other)), number_(number), count_(count),
+          items_(std::move(items)) {}
+
+    /// True if the parse worked
+    bool ok() const { return kind_ == Kind::Success; }
+
+    explicit operator bool() const { return ok(); }
+
+    /// What went wrong
+    Kind get_kind() const { return kind_; }
+
+    /// The exit code of the error (Success also for a call for help), without making the error
+    int get_exit_code() const {
+        switch(kind_) {
+        case Kind::Success:
+        case Kind::CallForHelp:
+            return static_cast<int>(ExitCodes::Success);
+        case Kind::FileMissing:
+        case Kind::FileRecursive:
+            return static_cast<int>(ExitCodes::FileError);
+        case Kind::Conversion:
+        case Kind::ConversionAt:
+        case Kind::ConversionTooManyInputsFlag:
+        case Kind::ConversionTrueFalse:
+            return static_cast<int>(ExitCodes::ConversionError);
+        case Kind::Validation:
+            return static_cast<int>(ExitCodes::ValidationError);
+        case Kind::Required:
+        case Kind::RequiredSubcommand:
+            return static_cast<int>(ExitCodes::RequiredError);
+        case Kind::ArgumentMismatch:
+        case Kind::ArgumentMismatchAtLeast:
+        case Kind::ArgumentMismatchTypedAtLeast:
+            return static_cast<int>(ExitCodes::ArgumentMismatch);
+        case Kind::Requires:
+            return static_cast<int>(ExitCodes::RequiresError);
+        case Kind::Excludes:
+            return static_cast<int>(ExitCodes::ExcludesError);
+        case Kind::Extras:
+            return static_cast<int>(ExitCodes::ExtrasError);
+        case Kind::INIExtras:
+        case Kind::ININotConfigurable:
+            return static_cast<int>(ExitCodes::INIError);
+        case Kind::Horrible:
+            return static_cast<int>(ExitCodes::HorribleError);
+        }
+        return static_cast<int>(ExitCodes::BaseClass);
+    }
+
+    /// Make the error this stands for and pass it to a function (nothing is called on success).
+    ///
+    /// The function is called with the derived error type, so it can take a `const Error &` or be a template.
+    template <typename Function> void visit(Function &&function) const {
+        switch(kind_) {
+        case Kind::Success:
+            return;
+        case Kind::CallForHelp:
+            return function(CallForHelp());
+        case Kind::FileMissing:
+            return function(FileError::Missing(name_));
+        case Kind::FileRecursive:
+            return function(FileError::Recursive(name_));
+        case Kind::Conversion:
+            return function(ConversionError(name_, items_));
+        case Kind::ConversionAt:
+            return function(ConversionError::At(name_, count_, other_));
+        case Kind::ConversionTooManyInputsFlag:
+            return function(ConversionError::TooManyInputsFlag(name_));
+        case Kind::ConversionTrueFalse:
+            return function(ConversionError::TrueFalse(name_));
+        case Kind::Validation:
+            return function(ValidationError(name_, other_));
+        case Kind::Required:
+            return function(RequiredError(name_));
+        case Kind::RequiredSubcommand:
+            return function(RequiredError::Subcommand(static_cast<size_t>(number_)));
+        case Kind::ArgumentMismatch:
+            return function(ArgumentMismatch(name_, number_, count_));
+        case Kind::ArgumentMismatchAtLeast:
+            return function(ArgumentMismatch::AtLeast(name_, number_));
+        case Kind::ArgumentMismatchTypedAtLeast:
+            return function(ArgumentMismatch::TypedAtLeast(name_, number_, other_));
+        case Kind::Requires:
+            return function(RequiresError(name_, other_));
+        case Kind::Excludes:
+            return function(ExcludesError(name_, other_));
+        case Kind::Extras:
+            return function(ExtrasError(items_));
+        case Kind::INIExtras:
+            return function(INIError::Extras(name_));
+        case Kind::ININotConfigurable:
+            return function(INIError::NotConfigurable(name_));
+        case Kind::Horrible:
+            return function(HorribleError(name_));
+        }
+    }
+
+    /// The name of the error, such as "ExtrasError" (empty on success)
+    std::string get_name() const {
+        std::string name;
+        visit([&name](const Error &e) { name = e.get_name(); });
+        return name;
+    }
+
+    /// The error message (empty on success)
+    std::string what() const {
+        std::string message;
+        visit([&message](const Error &e) { message = e.what(); });
+        return message;
+    }
+
+    /// Throw the error, if there is one
+    void raise() const { visit(Raiser()); }
+};
+
+} // namespace CLI
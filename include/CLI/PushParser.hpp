@@ -0,0 +1,67 @@
+#pragma once
+
+// Distributed under the 3-Clause BSD License.  See accompanying
+// file LICENSE or https://github.com/CLIUtils/CLI11 for details.
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+#include "CLI/App.hpp"
+#include "CLI/TokenStream.hpp"
+
+namespace CLI {
+
+/// Parses a command line that arrives one argument at a time, for example over a connection.
+///
+/// Each argument is parsed as soon as it is known how many values it takes. `finish` parses anything still waiting
+/// and then checks and runs the callbacks, leaving the App just as `App::parse` would have with all the arguments.
+class PushParser {
+    App *app_;
+    detail::TokenStream tokens_;
+    App::ParseCursor cursor_;
+
+    /// Parse every argument that has all the values it needs, throws the error if one fails
+    void advance() {
+        while(!tokens_.empty() && cursor_.apps.back()->_ready(tokens_, cursor_, nullptr))
+            if(!cursor_.apps.back()->_parse_single(tokens_, cursor_, nullptr))
+                app_->_status(nullptr).raise();
+    }
+
+  public:
+    /// Start parsing into an App (the App is validated now, unless it is frozen)
+    explicit PushParser(App &app) : app_(&app) {
+        if(!app_->frozen_)
+            app_->_validate();
+        app_->_compact_results();
+        app_->_status(nullptr) = ParseStatus();
+        app_->_enter(cursor_, nullptr);
+    }
+
+    /// Add the next argument (without the program name). Returns false while an option is waiting for values.
+    bool feed(std::string arg) {
+        tokens_.push_back(std::move(arg));
+        advance();
+        return tokens_.empty();
+    }
+
+    /// True if an option is waiting for values (an unlimited option waits for the argument after its values)
+    bool needs_more() const { return !tokens_.empty(); }
+
+    /// The number of arguments given but not parsed yet
+    std::size_t pending() const { return tokens_.size(); }
+
+    /// No more arguments: parse the ones waiting, then check and run the callbacks like `App::parse`
+    void finish() {
+        while(!tokens_.empty())
+            if(!cursor_.apps.back()->_parse_single(tokens_, cursor_, nullptr))
+                app_->_status(nullptr).raise();
+        if(tokens_.stopped())
+            return;
+        if(!App::_finish(cursor_, nullptr))
+            app_->_status(nullptr).raise();
+        app_->run_callback();
+    }
+};
+
+} // namespace CLI
@@ -0,0 +1,134 @@
+#pragma once
+
+// Distributed under the 3-Clause BSD License.  See accompanying
+// file LICENSE or https://github.com/CLIUtils/CLI11 for details.
+
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <locale>
+#include <sstream>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CLI11_HAS_MMAP
+#endif
+
+namespace CLI {
+namespace detail {
+
+/// The read-only contents of a file, mapped into memory where possible (read into a buffer otherwise)
+class MappedFile {
+    const char *data_{nullptr};
+    std::size_t size_{0};
+
+    /// Identifies the file, so the same file is found through any path
+    std::string key_;
+
+#ifdef CLI11_HAS_MMAP
+    void *map_{nullptr};
+#else
+    std::string buffer_;
+#endif
+
+  public:
+    MappedFile() = default;
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /// Map a file, returns false if it cannot be read
+    bool open(const std::string &path) {
+#ifdef CLI11_HAS_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if(fd < 0)
+            return false;
+        struct stat info;
+        if(::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+            ::close(fd);
+            return false;
+        }
+        size_ = static_cast<std::size_t>(info.st_size);
+        key_ = std::to_string(info.st_dev) + ":" + std::to_string(info.st_ino);
+
+        // An empty file cannot be mapped, and has nothing to map anyway
+        if(size_ > 0) {
+            map_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(map_ == MAP_FAILED) {
+                map_ = nullptr;
+                size_ = 0;
+                ::close(fd);
+                return false;
+            }
+            data_ = static_cast<const char *>(map_);
+        }
+        ::close(fd);
+#else
+        std::ifstream input{path, std::ios::binary};
+        if(!input.good())
+            return false;
+        std::ostringstream contents;
+        contents << input.rdbuf();
+        buffer_ = contents.str();
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+        key_ = path;
+#endif
+        return true;
+    }
+
+    ~MappedFile() {
+#ifdef CLI11_HAS_MMAP
+        if(map_ != nullptr)
+            ::munmap(map_, size_);
+#endif
+    }
+
+    const char *data() const { return data_; }
+    std::size_t size() const { return size_; }
+    const std::string &key() const { return key_; }
+};
+
+/// Split text into arguments by the rules of `split_up`, calling `add(data, size)` for each one.
+///
+/// Arguments are separated by whitespace, and one starting with a `'` or `"` runs to the matching quote (or the end)
+/// with the quotes removed. Nothing is unescaped, so every argument is a range of the text and nothing is copied.
+template <typename Callback> void split_up_views(const char *data, std::size_t size, Callback add) {
+    const std::ctype<char> &facet = std::use_facet<std::ctype<char>>(std::locale());
+    const char *end = data + size;
+    const char *pos = data;
+
+    while(true) {
+        while(pos != end && facet.is(std::ctype_base::space, *pos))
+            ++pos;
+        if(pos == end)
+            return;
+
+        if(*pos == '\'' || *pos == '\"') {
+            const char *start = pos + 1;
+            const void *close = std::memchr(start, *pos, static_cast<std::size_t>(end - start));
+            if(close == nullptr) {
+                // An unclosed quote takes the rest, without the trailing whitespace
+                while(end != start && facet.is(std::ctype_base::space, end[-1]))
+                    --end;
+                add(start, static_cast<std::size_t>(end - start));
+                return;
+            }
+            const char *stop = static_cast<const char *>(close);
+            add(start, static_cast<std::size_t>(stop - start));
+            pos = stop + 1;
+        } else {
+            const char *start = pos;
+            while(pos != end && !facet.is(std::ctype_base::space, *pos))
+                ++pos;
+            add(start, static_cast<std::size_t>(pos - start));
+        }
+    }
+}
+
+} // namespace detail
+} // namespace CLI
@@ -0,0 +1,162 @@
+#pragma once
+
+// Distributed under the 3-Clause BSD License.  See accompanying
+// file LICENSE or https://github.com/CLIUtils/CLI11 for details.
+
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "CLI/StringView.hpp"
+
+namespace CLI {
+namespace detail {
+
+/// The location of one result in a ResultArena
+struct ResultSpan {
+    std::size_t offset;
+    std::size_t size;
+};
+
+/// Contiguous storage for the text of all the results of a parse.
+///
+/// Results are appended and referred to by offset, so the storage can grow without invalidating them. Everything is
+/// released at once with `clear`, which keeps the capacity for the next parse; `App` compacts the values still in use
+/// before a parse, so the text of replaced or cleared results does not pile up.
+class ResultArena {
+    std::string buffer_;
+
+  public:
+    /// Copy a value into the arena
+    ResultSpan add(string_view value) {
+        ResultSpan span{buffer_.size(), value.size()};
+        buffer_.append(value.data(), value.size());
+        return span;
+    }
+
+    /// Replace a stored value, in place if the new one is not longer
+    void replace(ResultSpan &span, string_view value) {
+        if(value.size() <= span.size) {
+            buffer_.replace(span.offset, value.size(), value.data(), value.size());
+            span.size = value.size();
+        } else {
+            span = add(value);
+        }
+    }
+
+    /// View a stored value (valid until the next `add` or `clear`)
+    string_view view(ResultSpan span) const { return string_view(buffer_.data() + span.offset, span.size); }
+
+    /// Make a copy of a stored value
+    std::string str(ResultSpan span) const { return std::string(buffer_.data() + span.offset, span.size); }
+
+    /// Make copies of a run of stored values
+    std::vector<std::string> strs(const ResultSpan *begin, const ResultSpan *end) const {
+        std::vector<std::string> values;
+        values.reserve(static_cast<std::size_t>(end - begin));
+        for(const ResultSpan *span = begin; span != end; ++span)
+            values.emplace_back(buffer_.data() + span->offset, span->size);
+        return values;
+    }
+
+    /// Release all the values
+    void clear() { buffer_.clear(); }
+
+    /// The number of bytes stored
+    std::size_t size() const { return buffer_.size(); }
+};
+
+/// Store a value as one result, or as one result for each piece between delimiters ('\0' for none). The value is copied
+/// once and the pieces are found in the copy, so no string is made for any of them.
+inline void add_split(ResultArena &arena, string_view value, char delimiter, std::vector<ResultSpan> &spans) {
+    ResultSpan span = arena.add(value);
+    if(delimiter != '\0') {
+        const char *first = value.data();
+        const char *last = first + value.size();
+        while(const void *found = std::memchr(first, delimiter, static_cast<std::size_t>(last - first))) {
+            std::size_t size = static_cast<std::size_t>(static_cast<const char *>(found) - first);
+            spans.push_back(ResultSpan{span.offset, size});
+            span.offset += size + 1;
+            span.size -= size + 1;
+            first += size + 1;
+        }
+    }
+    spans.push_back(span);
+}
+
+} // namespace detail
+
+/// A read-only view of the results of an option, as given to an option callback.
+///
+/// The values are read from the arena of the App as views, no copies are made unless asked for with `strs`.
+class ResultsView {
+    const detail::ResultArena *arena_;
+    const detail::ResultSpan *begin_;
+    const detail::ResultSpan *end_;
+
+    /// The value a callback could not convert, size() if it did not say
+    mutable std::size_t failed_;
+
+  public:
+    /// Iterates over the values as string_views
+    class iterator {
+        const detail::ResultArena *arena_;
+        const detail::ResultSpan *span_;
+
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const string_view *;
+        using reference = string_view;
+
+        iterator(const detail::ResultArena *arena, const detail::ResultSpan *span) : arena_(arena), span_(span) {}
+
+        string_view operator*() const { return arena_->view(*span_); }
+        iterator &operator++() {
+            ++span_;
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator old = *this;
+            ++span_;
+            return old;
+        }
+        bool operator==(const iterator &other) const { return span_ == other.span_; }
+        bool operator!=(const iterator &other) const { return span_ != other.span_; }
+    };
+
+    ResultsView(const detail::ResultArena *arena, const detail::ResultSpan *begin, const detail::ResultSpan *end)
+        : arena_(arena), begin_(begin), end_(end), failed_(size()) {}
+
+    /// The number of values
+    std::size_t size() const { return static_cast<std::size_t>(end_ - begin_); }
+
+    /// True if there are no values
+    bool empty() const { return begin_ == end_; }
+
+    /// Get a value (no bounds checking)
+    string_view operator[](std::size_t i) const { return arena_->view(begin_[i]); }
+
+    /// The first value
+    string_view front() const { return arena_->view(*begin_); }
+
+    /// The last value
+    string_view back() const { return arena_->view(*(end_ - 1)); }
+
+    iterator begin() const { return iterator(arena_, begin_); }
+    iterator end() const { return iterator(arena_, end_); }
+
+    /// Let a callback say which value it could not convert, so the error can point at just that one
+    void fail_at(std::size_t index) const { failed_ = index; }
+
+    /// The index of the value that could not be converted, size() if no callback said
+    std::size_t failed_at() const { return failed_; }
+
+    /// Make copies of all the values
+    std::vector<std::string> strs() const { return arena_->strs(begin_, end_); }
+};
+
+} // namespace CLI
@@ -0,0 +1,106 @@
+#pragma once
+
+// Distributed under the 3-Clause BSD License.  See accompanying
+// file LICENSE or https://github.com/CLIUtils/CLI11 for details.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <string>
+
+#include "CLI/Macros.hpp"
+
+// [CLI11:verbatim]
+#ifdef __has_include
+#if defined(CLI11_CPP17) && __has_include(<string_view>) && !defined(CLI11_STD_STRING_VIEW)
+#define CLI11_STD_STRING_VIEW
+#endif
+#endif
+
+#ifdef CLI11_STD_STRING_VIEW
+#include <string_view>
+#endif
+// [CLI11:verbatim]
+
+namespace CLI {
+
+#ifdef CLI11_STD_STRING_VIEW
+using std::string_view;
+#else
+
+namespace detail {
+/// Holds npos, so that it can be defined in a header before C++17
+template <typename T = void> struct string_view_base { static const std::size_t npos; };
+template <typename T> const std::size_t string_view_base<T>::npos = static_cast<std::size_t>(-1);
+} // namespace detail
+
+/// A non-owning reference to a run of characters, standing in for std::string_view before C++17.
+///
+/// Only the parts of the std::string_view interface used by CLI11 are provided, so code written against this
+/// compiles with either one.
+class string_view : public detail::string_view_base<> {
+    const char *data_{nullptr};
+    std::size_t size_{0};
+
+  public:
+    constexpr string_view() = default;
+    constexpr string_view(const char *data, std::size_t size) : data_(data), size_(size) {}
+    string_view(const char *data) : data_(data), size_(std::strlen(data)) {}
+    string_view(const std::string &str) : data_(str.data()), size_(str.size()) {}
+
+    /// Make a copy (explicit, as for std::string from a std::string_view)
+    explicit operator std::string() const { return std::string(data_, size_); }
+
+    constexpr const char *data() const { return data_; }
+    constexpr std::size_t size() const { return size_; }
+    constexpr std::size_t length() const { return size_; }
+    constexpr bool empty() const { return size_ == 0; }
+
+    constexpr const char *begin() const { return data_; }
+    constexpr const char *end() const { return data_ + size_; }
+
+    constexpr const char &operator[](std::size_t pos) const { return data_[pos]; }
+    constexpr const char &front() const { return data_[0]; }
+    constexpr const char &back() const { return data_[size_ - 1]; }
+
+    void remove_prefix(std::size_t n) {
+        data_ += n;
+        size_ -= n;
+    }
+    void remove_suffix(std::size_t n) { size_ -= n; }
+
+    /// Sub view (like std::string_view, pos must not be past the end)
+    string_view substr(std::size_t pos, std::size_t n = npos) const {
+        return string_view(data_ + pos, std::min(n, size_ - pos));
+    }
+
+    /// Find a character, npos if not found
+    std::size_t find(char c, std::size_t pos = 0) const {
+        if(pos >= size_)
+            return npos;
+        const void *loc = std::memchr(data_ + pos, c, size_ - pos);
+        return loc == nullptr ? npos : static_cast<std::size_t>(static_cast<const char *>(loc) - data_);
+    }
+
+    int compare(string_view other) const {
+        int result = size_ == 0 || other.size_ == 0 ? 0 : std::memcmp(data_, other.data_, std::min(size_, other.size_));
+        if(result != 0)
+            return result;
+        return size_ == other.size_ ? 0 : (size_ < other.size_ ? -1 : 1);
+    }
+
+    friend bool operator==(string_view a, string_view b) {
+        return a.size_ == b.size_ && (a.size_ == 0 || std::memcmp(a.data_, b.data_, a.size_) == 0);
+    }
+    friend bool operator!=(string_view a, string_view b) { return !(a == b); }
+    friend bool operator<(string_view a, string_view b) { return a.compare(b) < 0; }
+
+    friend std::ostream &operator<<(std::ostream &out, string_view str) {
+        return out.write(str.data_, static_cast<std::streamsize>(str.size_));
+    }
+};
+
+#endif
+
+} // namespace CLI
@@ -0,0 +1,276 @@
+#pragma once
+
+// Distributed under the 3-Clause BSD License.  See accompanying
+// file LICENSE or https://github.com/CLIUtils/CLI11 for details.
+
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "CLI/ParseStatus.hpp"
+#include "CLI/ResponseFile.hpp"
+#include "CLI/StringTools.hpp"
+#include "CLI/StringView.hpp"
+
+namespace CLI {
+namespace detail {
+
+enum class Classifer { NONE, POSITIONAL_MARK, SHORT, LONG, SUBCOMMAND };
+
+/// One command line argument, along with its shape. The text is not owned.
+///
+/// For a LONG argument (`--name=value`) the spans are the name and the value after the `=`, for a SHORT argument
+/// (`-nrest`) they are the single character name and the rest. Both spans are empty otherwise.
+///
+/// A SHORT argument can also be the tail of a cluster (`-abc` after `a` is parsed): the name then starts after the
+/// second character, and `str()` gives the tail as its own argument (`-bc`).
+struct Token {
+    const char *data;
+    std::size_t size;
+    std::size_t name_begin;
+    std::size_t name_size;
+    std::size_t value_begin;
+    std::size_t value_size;
+
+    /// NONE, POSITIONAL_MARK, SHORT, or LONG. SUBCOMMAND depends on the parse state, so it is never stored here.
+    Classifer kind;
+
+    /// True if this is a long option with an `=` (the value may still be empty)
+    bool has_value;
+
+    /// The full argument text
+    string_view text() const { return string_view(data, size); }
+
+    /// The name span
+    string_view name_view() const { return string_view(data + name_begin, name_size); }
+
+    /// The value span
+    string_view value_view() const { return string_view(data + value_begin, value_size); }
+
+    /// True if this is the tail of a short option cluster, which does not start with a dash
+    bool cluster_tail() const { return kind == Classifer::SHORT && name_begin > 1; }
+
+    /// Make a copy of the full argument text
+    std::string str() const {
+        if(cluster_tail())
+            return "-" + std::string(data + name_begin, size - name_begin);
+        return std::string(data, size);
+    }
+
+    /// Make a copy of the name span
+    std::string name() const { return std::string(data + name_begin, name_size); }
+
+    /// Make a copy of the value span
+    std::string value() const { return std::string(data + value_begin, value_size); }
+};
+
+/// Work out the shape of an argument, the same way split_long and split_short do, without copying anything
+inline Token classify(const char *data, std::size_t size) {
+    Token token{data, size, 0, 0, 0, 0, Classifer::NONE, false};
+
+    if(size == 2 && data[0] == '-' && data[1] == '-') {
+        token.kind = Classifer::POSITIONAL_MARK;
+    } else if(size > 2 && data[0] == '-' && data[1] == '-' && valid_first_char(data[2])) {
+        token.kind = Classifer::LONG;
+        token.name_begin = 2;
+        const void *loc = std::memchr(data + 2, '=', size - 2);
+        if(loc != nullptr) {
+            std::size_t eq = static_cast<std::size_t>(static_cast<const char *>(loc) - data);
+            token.name_size = eq - 2;
+            token.value_begin = eq + 1;
+            token.value_size = size - eq - 1;
+            token.has_value = true;
+        } else {
+            token.name_size = size - 2;
+            token.value_begin = size;
+        }
+    } else if(size > 1 && data[0] == '-' && valid_first_char(data[1])) {
+        token.kind = Classifer::SHORT;
+        token.name_begin = 1;
+        token.name_size = 1;
+        token.value_begin = 2;
+        token.value_size = size - 2;
+    }
+
+    return token;
+}
+
+/// Classify a block of C string arguments into `out`. Each argument is only looked at up to its first few characters
+/// (and its `=` if it is a long option), so blocks can be classified independently, on any thread.
+inline void classify_all(const char *const *args, std::size_t count, Token *out) {
+    for(std::size_t i = 0; i < count; i++)
+        out[i] = classify(args[i], std::strlen(args[i]));
+}
+
+/// The arguments of one parse, classified once up front and consumed from the front.
+///
+/// The text of the arguments must outlive the stream, except for arguments added with `push_front` or read from a
+/// response file, which are owned.
+class TokenStream {
+    std::vector<Token> tokens_;
+    std::size_t pos_{0};
+
+    /// Set by `stop`, the rest of the arguments are not parsed
+    bool stopped_{false};
+
+    /// The position `stop` was called at, where the unparsed arguments start
+    std::size_t stopped_at_{0};
+
+    /// Storage for arguments made up while parsing (deque, so the text does not move)
+    std::deque<std::string> owned_;
+
+    /// Response files read by `expand_response_files`, their tokens point into them
+    std::vector<std::unique_ptr<MappedFile>> files_;
+
+    /// Add an argument to a list of tokens, or the contents of the file if it is `@path`. Returns false, with the
+    /// reason in the status, if a file cannot be read or includes itself.
+    bool expand(const char *data,
+                std::size_t size,
+                std::vector<Token> &out,
+                std::vector<std::string> &active,
+                ParseStatus &status) {
+        if(size < 2 || data[0] != '@') {
+            out.push_back(classify(data, size));
+            return true;
+        }
+
+        std::string path{data + 1, size - 1};
+        std::unique_ptr<MappedFile> file{new MappedFile()};
+        if(!file->open(path)) {
+            status = ParseStatus(ParseStatus::Kind::FileMissing, path);
+            return false;
+        }
+        if(std::find(std::begin(active), std::end(active), file->key()) != std::end(active)) {
+            status = ParseStatus(ParseStatus::Kind::FileRecursive, path);
+            return false;
+        }
+        const MappedFile &contents = *file;
+        files_.push_back(std::move(file));
+
+        active.push_back(contents.key());
+        bool ok = true;
+        split_up_views(contents.data(), contents.size(), [&](const char *arg, std::size_t length) {
+            ok = ok && expand(arg, length, out, active, status);
+        });
+        active.pop_back();
+        return ok;
+    }
+
+  public:
+    TokenStream() = default;
+
+    /// Classify a reversed list of arguments (the last one is the first to be parsed)
+    explicit TokenStream(const std::vector<std::string> &args) {
+        tokens_.reserve(args.size());
+        for(auto it = args.rbegin(); it != args.rend(); ++it)
+            tokens_.push_back(classify(it->data(), it->size()));
+    }
+
+    /// Classify arguments in place, in the order given, without copying them
+    TokenStream(std::size_t count, const char *const *args) : tokens_(count) {
+        classify_all(args, count, tokens_.data());
+    }
+
+    /// Take arguments classified ahead of time, in the order given (see `classify_all`)
+    explicit TokenStream(std::vector<Token> tokens) : tokens_(std::move(tokens)) {}
+
+    /// Classify a list of views in place, in the order given
+    TokenStream(const string_view *args, std::size_t count) {
+        tokens_.reserve(count);
+        for(std::size_t i = 0; i < count; i++)
+            tokens_.push_back(classify(args[i].data(), args[i].size()));
+    }
+
+    /// Replace every remaining `@path` argument with the arguments in that file, split like `split_up`. Files can name
+    /// other files; a file that cannot be read or (indirectly) names itself is a FileError, returned in the status with
+    /// false. The files are mapped, not copied.
+    bool expand_response_files(ParseStatus &status) {
+        bool found = std::any_of(tokens_.begin() + static_cast<std::ptrdiff_t>(pos_), tokens_.end(), [](const Token &t) {
+            return t.size > 1 && t.data[0] == '@';
+        });
+        if(!found)
+            return true;
+
+        std::vector<Token> expanded;
+        expanded.reserve(size());
+        std::vector<std::string> active;
+        for(std::size_t i = pos_; i < tokens_.size(); i++)
+            if(!expand(tokens_[i].data, tokens_[i].size, expanded, active, status))
+                return false;
+        tokens_.swap(expanded);
+        pos_ = 0;
+        return true;
+    }
+
+    /// True if all the arguments have been consumed
+    bool empty() const { return pos_ == tokens_.size(); }
+
+    /// The number of arguments left
+    std::size_t size() const { return tokens_.size() - pos_; }
+
+    /// The next argument
+    const Token &front() const { return tokens_[pos_]; }
+
+    /// A following argument (0 is the next one)
+    const Token &operator[](std::size_t i) const { return tokens_[pos_ + i]; }
+
+    /// Consume the next argument
+    void pop_front() { ++pos_; }
+
+    /// Consume all the remaining arguments unparsed, and ignore any added later
+    void stop() {
+        stopped_at_ = pos_;
+        pos_ = tokens_.size();
+        stopped_ = true;
+    }
+
+    /// True if `stop` was called
+    bool stopped() const { return stopped_; }
+
+    /// Copies of the arguments that were not parsed (including the ones skipped by `stop`), reversed
+    std::vector<std::string> remaining_reversed() const {
+        std::vector<std::string> args;
+        std::size_t first = stopped_ ? stopped_at_ : pos_;
+        for(std::size_t i = tokens_.size(); i > first; i--)
+            args.push_back(tokens_[i - 1].str());
+        return args;
+    }
+
+    /// Consume the first option of a short option cluster (`-abc` becomes `-bc`) in place. Returns false, changing
+    /// nothing, if the next argument has no more options in it.
+    bool next_short() {
+        Token &token = tokens_[pos_];
+        if(token.kind != Classifer::SHORT || token.value_size == 0 || !valid_first_char(token.data[token.value_begin]))
+            return false;
+        token.name_begin++;
+        token.value_begin++;
+        token.value_size--;
+        return true;
+    }
+
+    /// Add an argument after the remaining ones (the text is owned), nothing once stopped
+    void push_back(std::string arg) {
+        if(stopped_)
+            return;
+        owned_.push_back(std::move(arg));
+        tokens_.push_back(classify(owned_.back().data(), owned_.back().size()));
+    }
+
+    /// Put a new argument in front of the remaining ones. The slot of the last consumed argument is reused.
+    void push_front(std::string arg) {
+        owned_.push_back(std::move(arg));
+        Token token = classify(owned_.back().data(), owned_.back().size());
+        if(pos_ > 0)
+            tokens_[--pos_] = token;
+        else
+            tokens_.insert(tokens_.begin(), token);
+    }
+};
+
+} // namespace detail
+} // namespace CLI
@@ -3,11 +3,39 @@
 // Distributed under the 3-Clause BSD License.  See accompanying
 // file LICENSE or https://github.com/CLIUtils/CLI11 for details.
 
-#include <exception>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <clocale>
+#include <cstring>
+#include <limits>
+#include <sstream>
 #include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "CLI/Macros.hpp"
+#include "CLI/StringView.hpp"
+
+// Integers are read with std::from_chars where it exists, floats only where the library has it for them too
+#if defined(CLI11_CPP17) && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#define CLI11_HAS_FROM_CHARS
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define CLI11_HAS_FROM_CHARS_FLOAT
+#endif
+#endif
+#endif
+
+// Decimal digits are checked and read eight at a time from a 64-bit word, which needs the first digit in the low byte
+#if(defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || defined(_M_X64) || defined(_M_IX86) || \
+    defined(_M_ARM64)
+#define CLI11_SWAR_DIGITS
+#endif
+
 namespace CLI {
 
 // Type tools
@@ -26,6 +54,13 @@ template <typename T> struct is_bool { static const bool value = false; };
 
 template <> struct is_bool<bool> { static bool const value = true; };
 
+/// The conversion of a type from text, to be specialized for user types.
+///
+/// A specialization gives `static bool parse(string_view input, T &output)`, returning false if the input is not
+/// valid. Every conversion (`add_option`, `add_set`, optionals, validators) uses it ahead of the built in ones, so a
+/// type with a parser is read straight from the view instead of through a `std::istringstream`.
+template <typename T, typename Enable = void> struct parser {};
+
 namespace detail {
 // Based generally on https://rmf.io/cxx11/almost-static-if
 /// Simple empty scoped class
@@ -70,79 +105,329 @@ constexpr const char *type_name() {
     return "TEXT";
 }
 
-// Lexical cast
+// Number conversion
 
-/// Signed integers / enums
-template <typename T,
-          enable_if_t<(std::is_integral<T>::value && std::is_signed<T>::value), detail::enabler> = detail::dummy>
-bool lexical_cast(std::string input, T &output) {
-    try {
-        size_t n = 0;
-        long long output_ll = std::stoll(input, &n, 0);
-        output = static_cast<T>(output_ll);
-        return n == input.size() && static_cast<long long>(output) == output_ll;
-    } catch(const std::invalid_argument &) {
-        return false;
-    } catch(const std::out_of_range &) {
+/// Why a number could not be read
+enum class NumberError { None, Invalid, OutOfRange };
+
+/// True for the whitespace skipped before a number (the "C" locale set)
+inline bool number_space(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+/// The value of a digit or letter in bases up to 36, or 36 if it is neither
+inline int digit_value(char c) {
+    if(c >= '0' && c <= '9')
+        return c - '0';
+    if(c >= 'a' && c <= 'z')
+        return c - 'a' + 10;
+    if(c >= 'A' && c <= 'Z')
+        return c - 'A' + 10;
+    return 36;
+}
+
+#ifdef CLI11_SWAR_DIGITS
+/// Read eight decimal digits with a few word operations, returns false if any character is not a digit
+inline bool read_digit_word(const char *first, std::uint32_t &value) {
+    std::uint64_t word;
+    std::memcpy(&word, first, 8);
+
+    // Every byte is a digit if its high half is 3, and still 3 after adding 6
+    if(((word & 0xF0F0F0F0F0F0F0F0ULL) | (((word + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) !=
+       0x3333333333333333ULL)
         return false;
+
+    // Combine the digits into pairs, then fours, then the whole eight
+    word -= 0x3030303030303030ULL;
+    word = (word * 10) + (word >> 8);
+    word = (((word & 0x000000FF000000FFULL) * 0x000F424000000064ULL) +
+            (((word >> 16) & 0x000000FF000000FFULL) * 0x0000271000000001ULL)) >>
+           32;
+    value = static_cast<std::uint32_t>(word);
+    return true;
+}
+
+/// Read a whole range of decimal digits, eight at a time
+inline NumberError parse_decimal(const char *first, const char *last, unsigned long long &value) {
+    if(first == last)
+        return NumberError::Invalid;
+    const unsigned long long limit = std::numeric_limits<unsigned long long>::max();
+
+    // The odd digits are read one at a time (faster than a partial word), so the rest come in full words
+    value = 0;
+    for(const char *head = first + (last - first) % 8; first != head; ++first) {
+        unsigned digit = static_cast<unsigned>(static_cast<unsigned char>(*first)) - '0';
+        if(digit > 9)
+            return NumberError::Invalid;
+        value = value * 10 + digit;
+    }
+    std::uint32_t part;
+    for(; first != last; first += 8) {
+        if(!read_digit_word(first, part))
+            return NumberError::Invalid;
+        if(value > (limit - part) / 100000000ULL)
+            return NumberError::OutOfRange;
+        value = value * 100000000ULL + part;
     }
+    return NumberError::None;
 }
+#endif
 
-/// Unsigned integers
-template <typename T,
-          enable_if_t<std::is_integral<T>::value && std::is_unsigned<T>::value, detail::enabler> = detail::dummy>
-bool lexical_cast(std::string input, T &output) {
-    if(!input.empty() && input.front() == '-')
-        return false; // std::stoull happily converts negative values to junk without any errors.
-
-    try {
-        size_t n = 0;
-        unsigned long long output_ll = std::stoull(input, &n, 0);
-        output = static_cast<T>(output_ll);
-        return n == input.size() && static_cast<unsigned long long>(output) == output_ll;
-    } catch(const std::invalid_argument &) {
-        return false;
-    } catch(const std::out_of_range &) {
-        return false;
+/// Read a whole range of digits in a base
+inline NumberError parse_digits(const char *first, const char *last, int base, unsigned long long &value) {
+#ifdef CLI11_SWAR_DIGITS
+    if(base == 10)
+        return parse_decimal(first, last, value);
+#endif
+#ifdef CLI11_HAS_FROM_CHARS
+    std::from_chars_result result = std::from_chars(first, last, value, base);
+    if(result.ec == std::errc::result_out_of_range)
+        return NumberError::OutOfRange;
+    if(result.ec != std::errc() || result.ptr != last)
+        return NumberError::Invalid;
+    return NumberError::None;
+#else
+    if(first == last)
+        return NumberError::Invalid;
+    const unsigned long long limit = std::numeric_limits<unsigned long long>::max();
+    value = 0;
+    for(; first != last; ++first) {
+        int digit = digit_value(*first);
+        if(digit >= base)
+            return NumberError::Invalid;
+        if(value > (limit - static_cast<unsigned long long>(digit)) / static_cast<unsigned long long>(base))
+            return NumberError::OutOfRange;
+        value = value * static_cast<unsigned long long>(base) + static_cast<unsigned long long>(digit);
+    }
+    return NumberError::None;
+#endif
+}
+
+/// Read an integer like `strtoll` with base 0 (leading whitespace, a sign, then `0x` for hex or `0` for octal), except
+/// that the whole input has to be used and the value has to fit in the type. Nothing is copied, the locale is not
+/// used, and nothing is thrown. A negative number is Invalid for an unsigned type.
+template <typename T, enable_if_t<std::is_integral<T>::value, detail::enabler> = detail::dummy>
+NumberError parse_number(string_view input, T &output) {
+    const char *first = input.data();
+    const char *last = first + input.size();
+    while(first != last && number_space(*first))
+        ++first;
+
+    bool negative = false;
+    if(first != last && (*first == '+' || *first == '-')) {
+        negative = *first == '-';
+        ++first;
+    }
+    if(negative && !std::is_signed<T>::value)
+        return NumberError::Invalid;
+
+    int base = 10;
+    if(last - first > 1 && first[0] == '0' && (first[1] == 'x' || first[1] == 'X')) {
+        base = 16;
+        first += 2;
+    } else if(first != last && *first == '0') {
+        base = 8;
     }
+
+    unsigned long long magnitude;
+    NumberError error = parse_digits(first, last, base, magnitude);
+    if(error != NumberError::None)
+        return error;
+
+    // The most negative value of a signed type is one further from zero than the largest
+    const unsigned long long largest = static_cast<unsigned long long>(std::numeric_limits<T>::max());
+    if(magnitude > (negative ? largest + 1 : largest))
+        return NumberError::OutOfRange;
+    if(negative && magnitude > 0)
+        output = static_cast<T>(-static_cast<long long>(magnitude - 1) - 1);
+    else
+        output = static_cast<T>(magnitude);
+    return NumberError::None;
 }
 
-/// Floats
+/// Read a floating point number with `strtold` on a copy, checking the whole input is used and the value fits in the
+/// type (a value too small for it becomes zero or a denormal, as with a cast). The number is always read with a `.`
+/// for the decimal point, whatever the locale of the C library.
+template <typename T> NumberError parse_float_strtold(string_view input, T &output) {
+    std::string text(input.data(), input.size());
+    const std::string point = std::localeconv()->decimal_point;
+    if(point != ".") {
+        if(text.find(point) != std::string::npos)
+            return NumberError::Invalid;
+        std::size_t dot = text.find('.');
+        if(dot != std::string::npos)
+            text.replace(dot, 1, point);
+    }
+    const char *begin = text.c_str();
+    char *end = nullptr;
+    errno = 0;
+    long double value = std::strtold(begin, &end);
+    if(end == begin || end != begin + text.size())
+        return NumberError::Invalid;
+    // On underflow strtold also gives ERANGE, with zero or a denormal instead of an infinity
+    if((errno == ERANGE && std::isinf(value)) ||
+       (std::isfinite(value) && (value > std::numeric_limits<T>::max() || value < std::numeric_limits<T>::lowest())))
+        return NumberError::OutOfRange;
+    output = static_cast<T>(value);
+    return NumberError::None;
+}
+
+#ifdef CLI11_HAS_FROM_CHARS_FLOAT
+/// True if the digits and exponent of a number (without sign or `0x`) that even a long double cannot hold make it
+/// too small rather than too large
+inline bool float_underflows(const char *first, const char *last, std::chars_format format) {
+    const int base = format == std::chars_format::hex ? 16 : 10;
+    const char marker = format == std::chars_format::hex ? 'p' : 'e';
+
+    // The position of the first significant digit, relative to the point, in digits
+    long long position = 0;
+    bool leading = true;
+    for(; first != last && digit_value(*first) < base; ++first)
+        if(!(leading = leading && *first == '0'))
+            ++position;
+    if(leading && first != last && *first == '.')
+        for(++first; first != last && *first == '0'; ++first)
+            --position;
+    while(first != last && (*first | 0x20) != marker)
+        ++first;
+
+    // The exponent, which is limited long before it could overflow
+    long long exponent = 0;
+    if(first != last && ++first != last) {
+        bool negative = *first == '-';
+        if(*first == '-' || *first == '+')
+            ++first;
+        for(; first != last && exponent < 1000000000LL; ++first)
+            exponent = exponent * 10 + (*first - '0');
+        if(negative)
+            exponent = -exponent;
+    }
+    return (format == std::chars_format::hex ? 4 * position : position) + exponent < 0;
+}
+
+/// Read a number `std::from_chars` found out of range for the type: too small for it becomes zero or a denormal, as
+/// with a cast, and too large is OutOfRange
+template <typename T>
+NumberError parse_float_out_of_range(const char *first, const char *last, std::chars_format format, bool negative,
+                                     T &output) {
+    long double value;
+    std::from_chars_result result = std::from_chars(first, last, value, format);
+    if(result.ec == std::errc::result_out_of_range) {
+        if(!float_underflows(first, last, format))
+            return NumberError::OutOfRange;
+        value = 0;
+    } else if(value > std::numeric_limits<T>::max()) {
+        return NumberError::OutOfRange;
+    }
+    output = static_cast<T>(negative ? -value : value);
+    return NumberError::None;
+}
+#endif
+
+/// Read a floating point number like `strtold` (leading whitespace, a sign, decimal or `0x` hex digits with an
+/// exponent, `inf` or `nan`), except that the whole input has to be used, the value has to fit in the type, and the
+/// locale is not used. With `std::from_chars` nothing is copied; otherwise `strtold` reads a copy. Nothing is thrown.
 template <typename T, enable_if_t<std::is_floating_point<T>::value, detail::enabler> = detail::dummy>
-bool lexical_cast(std::string input, T &output) {
-    try {
-        size_t n = 0;
-        output = static_cast<T>(std::stold(input, &n));
-        return n == input.size();
-    } catch(const std::invalid_argument &) {
-        return false;
-    } catch(const std::out_of_range &) {
-        return false;
+NumberError parse_number(string_view input, T &output) {
+#ifdef CLI11_HAS_FROM_CHARS_FLOAT
+    const char *first = input.data();
+    const char *last = first + input.size();
+    while(first != last && number_space(*first))
+        ++first;
+
+    bool negative = false;
+    if(first != last && (*first == '+' || *first == '-')) {
+        negative = *first == '-';
+        ++first;
     }
+
+    std::chars_format format = std::chars_format::general;
+    if(last - first > 1 && first[0] == '0' && (first[1] == 'x' || first[1] == 'X')) {
+        format = std::chars_format::hex;
+        first += 2;
+
+        // Hex digits have to follow, not `inf` or `nan`
+        if(first == last || (digit_value(*first) >= 16 && *first != '.'))
+            return NumberError::Invalid;
+    }
+
+    // from_chars takes a minus sign of its own, which would be a second sign here
+    if(first != last && *first == '-')
+        return NumberError::Invalid;
+
+    T value;
+    std::from_chars_result result = std::from_chars(first, last, value, format);
+
+    // Out of range is also given for values too small for the type
+    if(result.ec == std::errc::result_out_of_range && result.ptr == last)
+        return parse_float_out_of_range(first, last, format, negative, output);
+    if(result.ec != std::errc() || result.ptr != last)
+        return NumberError::Invalid;
+    output = negative ? -value : value;
+    return NumberError::None;
+#else
+    return parse_float_strtold(input, output);
+#endif
+}
+
+// Lexical cast
+
+template <typename T>
+auto has_parser_test(int)
+    -> decltype(parser<T>::parse(std::declval<string_view>(), std::declval<T &>()), std::true_type());
+template <typename> std::false_type has_parser_test(...);
+
+/// True if `CLI::parser<T>` has been specialized with a parse function
+template <typename T> struct has_parser : decltype(has_parser_test<T>(0)) {};
+
+/// Types with a parser
+template <typename T, enable_if_t<has_parser<T>::value, detail::enabler> = detail::dummy>
+bool lexical_cast(string_view input, T &output) {
+    return parser<T>::parse(input, output);
+}
+
+/// Integers and floats
+template <typename T,
+          enable_if_t<!has_parser<T>::value && (std::is_integral<T>::value || std::is_floating_point<T>::value),
+                      detail::enabler> = detail::dummy>
+bool lexical_cast(string_view input, T &output) {
+    return parse_number(input, output) == NumberError::None;
 }
 
 /// String and similar
 template <typename T,
-          enable_if_t<!std::is_floating_point<T>::value && !std::is_integral<T>::value &&
+          enable_if_t<!has_parser<T>::value && !std::is_floating_point<T>::value && !std::is_integral<T>::value &&
                           std::is_assignable<T &, std::string>::value,
                       detail::enabler> = detail::dummy>
-bool lexical_cast(std::string input, T &output) {
-    output = input;
+bool lexical_cast(string_view input, T &output) {
+    output = std::string(input.data(), input.size());
     return true;
 }
 
-/// Non-string parsable
+/// Non-string parsable, read with a stream
 template <typename T,
-          enable_if_t<!std::is_floating_point<T>::value && !std::is_integral<T>::value &&
+          enable_if_t<!has_parser<T>::value && !std::is_floating_point<T>::value && !std::is_integral<T>::value &&
                           !std::is_assignable<T &, std::string>::value,
                       detail::enabler> = detail::dummy>
-bool lexical_cast(std::string input, T &output) {
+bool lexical_cast(string_view input, T &output) {
     std::istringstream is;
 
-    is.str(input);
+    is.str(std::string(input.data(), input.size()));
     is >> output;
     return !is.fail() && !is.rdbuf()->in_avail();
 }
 
+/// Convert a whole range of values into a vector, sized once and swapped in when all of them worked. Returns the index
+/// of the first value that could not be converted (the vector is then left untouched), or the number of values.
+template <typename T, typename Values> std::size_t lexical_cast_all(const Values &values, std::vector<T> &output) {
+    std::vector<T> converted(values.size());
+    std::size_t index = 0;
+    for(string_view value : values) {
+        if(!lexical_cast(value, converted[index]))
+            return index;
+        ++index;
+    }
+    output.swap(converted);
+    return index;
+}
+
 } // namespace detail
 } // namespace CLI
@@ -5,9 +5,14 @@
 
 #include "CLI/TypeTools.hpp"
 
+#include <cstddef>
 #include <functional>
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 // C standard library
 // Only needed for existence checking
@@ -70,15 +75,47 @@ inline std::string NonexistentPath(const std::string &filename) {
     return std::string();
 }
 
-/// Produce a range validator function
+/// A range check of converted values (`->check_value<T>`), kept by value so nothing is converted again or allocated
+template <typename T> class RangeCheck {
+    T min_;
+    T max_;
+
+    bool outside(const T &value) const { return value < min_ || value > max_; }
+
+  public:
+    RangeCheck(T min, T max) : min_(min), max_(max) {}
+
+    /// Check a converted value
+    std::string operator()(const T &value) const {
+        if(!outside(value))
+            return std::string();
+        std::ostringstream out;
+        out << "Value " << value << " not in range " << min_ << " to " << max_;
+        return out.str();
+    }
+
+    /// The index of the first value outside the range, or count if there is none. The values are all compared first
+    /// without branching (which the compiler can vectorize), and only searched when one is outside.
+    std::size_t first_invalid(const T *values, std::size_t count) const {
+        bool any = false;
+        for(std::size_t i = 0; i < count; ++i)
+            any = any | (values[i] < min_) | (values[i] > max_);
+        if(!any)
+            return count;
+        std::size_t index = 0;
+        while(!outside(values[index]))
+            ++index;
+        return index;
+    }
+};
+
+/// Produce a range validator function. A value that does not convert is left for the option to report.
 template <typename T> std::function<std::string(const std::string &)> Range(T min, T max) {
     return [min, max](std::string input) {
         T val;
-        detail::lexical_cast(input, val);
-        if(val < min || val > max)
-            return "Value " + input + " not in range " + std::to_string(min) + " to " + std::to_string(max);
-
-        return std::string();
+        if(!detail::lexical_cast(input, val) || (val >= min && val <= max))
+            return std::string();
+        return "Value " + input + " not in range " + std::to_string(min) + " to " + std::to_string(max);
     };
 }
 
@@ -87,6 +124,98 @@ template <typename T> std::function<std::string(const std::string &)> Range(T ma
     return Range(static_cast<T>(0), max);
 }
 
+/// Produce a range check of converted values, for `->check_value<T>`
+template <typename T> RangeCheck<T> RangeValue(T min, T max) { return RangeCheck<T>(min, max); }
+
+/// Range of one converted value is 0 to value
+template <typename T> RangeCheck<T> RangeValue(T max) { return RangeCheck<T>(static_cast<T>(0), max); }
+
+namespace detail {
+
+/// Run a check with a `first_invalid` pass over a whole buffer of values
+template <typename T, typename Check>
+auto check_all(const Check &check, const T *values, std::size_t count, int)
+    -> decltype(check.first_invalid(values, count), std::string()) {
+    std::size_t index = check.first_invalid(values, count);
+    return index == count ? std::string() : check(values[index]);
+}
+
+/// Run any other check on each value in turn
+template <typename T, typename Check>
+std::string check_all(const Check &check, const T *values, std::size_t count, long) {
+    for(std::size_t i = 0; i < count; ++i) {
+        std::string message = check(values[i]);
+        if(!message.empty())
+            return message;
+    }
+    return std::string();
+}
+
+/// An address for each type, to tell which type a set of value checks takes
+template <typename T> const void *type_tag() {
+    static const char tag = 0;
+    return &tag;
+}
+
+/// The checks of the converted values of an option, whatever their type
+class ValueChecksBase {
+  public:
+    virtual ~ValueChecksBase() = default;
+
+    /// The message of the last failed check
+    std::string error;
+};
+
+/// The checks of the converted values of an option, each run once over all the values of a parse
+template <typename T> class ValueChecks : public ValueChecksBase {
+    /// Range checks of numbers are stored as they are, and run first
+    std::vector<RangeCheck<T>> ranges_;
+
+    /// Any other checks
+    std::vector<std::function<std::string(const T *, std::size_t)>> checks_;
+
+    using stores_ranges = std::is_arithmetic<T>;
+
+    void add_check(RangeCheck<T> check, std::true_type) { ranges_.push_back(check); }
+
+    template <typename Check> void add_check(Check check, std::false_type) {
+        checks_.emplace_back(
+            [check](const T *values, std::size_t count) { return check_all(check, values, count, 0); });
+    }
+
+    bool run_ranges(const T *values, std::size_t count, std::true_type) {
+        for(const RangeCheck<T> &range : ranges_) {
+            error = check_all(range, values, count, 0);
+            if(!error.empty())
+                return false;
+        }
+        return true;
+    }
+
+    bool run_ranges(const T *, std::size_t, std::false_type) { return true; }
+
+  public:
+    /// Add a check taking a value and returning an error message (empty if the value is fine)
+    template <typename Check> void add(Check check) {
+        add_check(std::move(check),
+                  std::integral_constant<bool, std::is_same<Check, RangeCheck<T>>::value && stores_ranges::value>());
+    }
+
+    /// Run all the checks, returns false (with the message in `error`) if one fails
+    bool run(const T *values, std::size_t count) {
+        if(!run_ranges(values, count, stores_ranges()))
+            return false;
+        for(const std::function<std::string(const T *, std::size_t)> &check : checks_) {
+            error = check(values, count);
+            if(!error.empty())
+                return false;
+        }
+        return true;
+    }
+};
+
+} // namespace detail
+
 /// @}
 
 } // namespace CLI
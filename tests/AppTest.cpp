@@ -1,6 +1,9 @@
 #include "app_helper.hpp"
 #include <cstdlib>
 #include <complex>
+#include <fstream>
+#include <sstream>
+#include <thread>
 
 TEST_F(TApp, OneFlagShort) {
     app.add_flag("-c,--count");
@@ -123,6 +126,38 @@ TEST_F(TApp, DualOptions) {
     EXPECT_THROW(run(), CLI::ArgumentMismatch);
 }
 
+TEST_F(TApp, ParseArgv) {
+
+    std::string str;
+    std::vector<std::string> vstr;
+    app.add_option("-s,--string", str);
+    app.add_option("-v,--vector", vstr);
+
+    const char *argv[] = {"prog", "--string=one", "-vtwo", "three"};
+    app.parse(4, argv);
+    EXPECT_EQ("prog", app.get_name());
+    EXPECT_EQ("one", str);
+    EXPECT_EQ(std::vector<std::string>({"two", "three"}), vstr);
+}
+
+TEST_F(TApp, ResetReleasesResults) {
+
+    std::vector<std::string> vstr;
+    CLI::Option *opt = app.add_option("-v,--vector", vstr);
+
+    args = {"-v", "one", "two"};
+    run();
+    EXPECT_EQ(std::vector<std::string>({"one", "two"}), opt->results());
+
+    app.reset();
+    EXPECT_EQ((size_t)0, opt->count());
+    EXPECT_TRUE(opt->results().empty());
+
+    args = {"-v", "three"};
+    run();
+    EXPECT_EQ(std::vector<std::string>({"three"}), opt->results());
+}
+
 TEST_F(TApp, LotsOfFlags) {
 
     app.add_flag("-a");
@@ -201,6 +236,27 @@ TEST_F(TApp, ShortOpts) {
     EXPECT_EQ("zyz", someopt);
 }
 
+TEST_F(TApp, ShortFlagClusters) {
+
+    int vflag = 0;
+    std::string someopt;
+    app.add_flag("-v", vflag);
+    app.add_option("-o", someopt);
+    app.allow_extras();
+
+    args = {"-" + std::string(10000, 'v')};
+    run();
+    EXPECT_EQ(10000, vflag);
+
+    // An unknown flag leaves the rest of the cluster as one extra argument
+    app.reset();
+    args = {"-vvxvo", "-vo-1", "-v1"};
+    run();
+    EXPECT_EQ(std::vector<std::string>({"-xvo", "-1"}), app.remaining());
+    EXPECT_EQ("-1", someopt);
+    EXPECT_EQ(4, vflag);
+}
+
 TEST_F(TApp, DefaultOpts) {
 
     int i = 3;
@@ -427,6 +483,24 @@ TEST_F(TApp, RequiredOptsDouble) {
     EXPECT_EQ(strs, std::vector<std::string>({"one", "two"}));
 }
 
+TEST_F(TApp, CallbacksRunBeforeChecks) {
+
+    int number = 0;
+    std::string first, last;
+    app.add_option("--first", first)->required();
+    app.add_option("--number", number);
+    app.add_option("--last", last)->required();
+
+    // Every callback runs before any option is checked, wherever the options are
+    args = {"--number", "x"};
+    EXPECT_THROW(run(), CLI::ConversionError);
+
+    app.reset();
+    args = {"--number", "1", "--first", "a"};
+    EXPECT_THROW(run(), CLI::RequiredError);
+    EXPECT_EQ(1, number);
+}
+
 TEST_F(TApp, RequiredOptsDoubleShort) {
 
     std::vector<std::string> strs;
@@ -809,6 +883,35 @@ TEST_F(TApp, MixedPositionals) {
     EXPECT_EQ("thing2", positional_string);
 }
 
+TEST_F(TApp, NamedPositionalStopsEating) {
+
+    int positional_int;
+    std::string positional_string;
+    std::vector<std::string> vals;
+    app.add_option("posit1,--posit1", positional_int, "");
+    app.add_option("posit2", positional_string, "");
+    app.add_option("-v", vals);
+
+    args = {"--posit1", "7", "-v", "one", "two"};
+
+    run();
+
+    EXPECT_EQ(7, positional_int);
+    EXPECT_EQ(std::vector<std::string>({"one"}), vals);
+    EXPECT_EQ("two", positional_string);
+
+    app.reset();
+
+    // Once every positional is filled, an unlimited option takes the rest
+    args = {"7", "thing", "-v", "one", "two", "three"};
+
+    run();
+
+    EXPECT_EQ(7, positional_int);
+    EXPECT_EQ("thing", positional_string);
+    EXPECT_EQ(std::vector<std::string>({"one", "two", "three"}), vals);
+}
+
 TEST_F(TApp, BigPositional) {
     std::vector<std::string> vec;
     app.add_option("pos", vec);
@@ -864,6 +967,57 @@ TEST_F(TApp, RemoveOption) {
     EXPECT_THROW(run(), CLI::ExtrasError);
 }
 
+TEST_F(TApp, RemoveOptionReAdd) {
+    auto opt = app.add_flag("-t,--two");
+    EXPECT_TRUE(app.remove_option(opt));
+
+    int two;
+    app.add_flag("--two,-t", two);
+
+    args = {"--two", "-t"};
+    run();
+    EXPECT_EQ(2, two);
+    EXPECT_EQ(2u, app.count("--two"));
+    EXPECT_EQ(2u, app.count("-t"));
+}
+
+TEST_F(TApp, RemoveOptionKeepsIdsDense) {
+    auto one = app.add_flag("--one");
+    auto two = app.add_flag("--two");
+    auto three = app.add_flag("--three");
+    three->needs(one);
+
+    EXPECT_EQ(1u, one->get_id());
+    EXPECT_EQ(3u, three->get_id());
+
+    EXPECT_TRUE(app.remove_option(two));
+    EXPECT_EQ(2u, three->get_id());
+
+    args = {"--three"};
+    EXPECT_THROW(run(), CLI::RequiresError);
+
+    app.reset();
+    args = {"--three", "--one"};
+    run();
+}
+
+TEST_F(TApp, IgnoreCaseAfterAdding) {
+    auto opt = app.add_flag("-a,--all");
+
+    args = {"-A", "--ALL"};
+    EXPECT_THROW(run(), CLI::ExtrasError);
+
+    app.reset();
+    opt->ignore_case();
+    run();
+    EXPECT_EQ(2u, app.count("--all"));
+    EXPECT_EQ(2u, app.count("--aLl"));
+
+    app.reset();
+    opt->ignore_case(false);
+    EXPECT_THROW(run(), CLI::ExtrasError);
+}
+
 TEST_F(TApp, FileNotExists) {
     std::string myfile{"TestNonFileNotUsed.txt"};
     EXPECT_NO_THROW(CLI::NonexistentPath(myfile));
@@ -922,6 +1076,47 @@ TEST_F(TApp, InSet) {
     EXPECT_THROW(run(), CLI::ConversionError);
 }
 
+enum class Level { Low, High };
+
+std::ostream &operator<<(std::ostream &out, Level level) { return out << (level == Level::Low ? "low" : "high"); }
+
+namespace CLI {
+template <> struct parser<Level> {
+    static bool parse(string_view input, Level &output) {
+        if(input == string_view("low"))
+            output = Level::Low;
+        else if(input == string_view("high"))
+            output = Level::High;
+        else
+            return false;
+        return true;
+    }
+};
+} // namespace CLI
+
+TEST_F(TApp, CustomParser) {
+    Level level{Level::Low};
+    std::vector<Level> levels;
+    Level chosen{Level::Low};
+    app.add_option("--level", level);
+    app.add_option("--levels", levels)->delimiter(',');
+    app.add_set("--chosen", chosen, {Level::High});
+
+    args = {"--level", "high", "--levels", "low,high", "--chosen", "high"};
+    run();
+    EXPECT_EQ(Level::High, level);
+    EXPECT_EQ(std::vector<Level>({Level::Low, Level::High}), levels);
+    EXPECT_EQ(Level::High, chosen);
+
+    app.reset();
+    args = {"--level", "medium"};
+    EXPECT_THROW(run(), CLI::ConversionError);
+
+    app.reset();
+    args = {"--chosen", "low"};
+    EXPECT_THROW(run(), CLI::ConversionError);
+}
+
 TEST_F(TApp, InSetWithDefault) {
 
     std::string choice = "one";
@@ -1065,6 +1260,82 @@ TEST_F(TApp, VectorUnlimString) {
     EXPECT_EQ(answer, strvec);
 }
 
+TEST_F(TApp, VectorConversionNamesBadValue) {
+    std::vector<int> values;
+    app.add_option("--values", values);
+
+    std::vector<std::string> input{"4", "x3", "2", "1", "--values"};
+    CLI::ParseStatus status = app.try_parse(input);
+    EXPECT_EQ(CLI::ParseStatus::Kind::ConversionAt, status.get_kind());
+    EXPECT_EQ(static_cast<int>(CLI::ExitCodes::ConversionError), status.get_exit_code());
+    EXPECT_EQ("Could not convert: --values[2] = x3", status.what());
+
+    // The bound vector keeps what it had
+    app.reset();
+    values = {7, 8};
+    input = {"4", "x3", "2", "1", "--values"};
+    status = app.try_parse(input);
+    EXPECT_FALSE(status.ok());
+    EXPECT_EQ(std::vector<int>({7, 8}), values);
+
+    app.reset();
+    args = {"--values", "1", "2", "3"};
+    run();
+    EXPECT_EQ(std::vector<int>({1, 2, 3}), values);
+}
+
+TEST_F(TApp, VectorDelimiter) {
+    std::vector<int> ids;
+    std::vector<std::string> names;
+    CLI::Option *opt = app.add_option("--ids", ids)->delimiter(',');
+    app.add_option("-n,--names", names)->delimiter(';');
+    EXPECT_EQ(',', opt->get_delimiter());
+
+    args = {"--ids", "1,2,3", "4", "--names=a;b;;c"};
+    run();
+    EXPECT_EQ((size_t)4, app.count("--ids"));
+    EXPECT_EQ(std::vector<int>({1, 2, 3, 4}), ids);
+    EXPECT_EQ(std::vector<std::string>({"a", "b", "", "c"}), names);
+
+    app.reset();
+    args = {"--ids=5,6", "-n", "x"};
+    run();
+    EXPECT_EQ(std::vector<int>({5, 6}), ids);
+    EXPECT_EQ(std::vector<std::string>({"x"}), names);
+
+    app.reset();
+    args = {"--ids", "7,,8"};
+    EXPECT_THROW(run(), CLI::ConversionError);
+
+    app.reset();
+    app.freeze();
+    CLI::ParseResult result = app.parse_result(std::vector<CLI::string_view>({"--ids=9,10"}));
+    EXPECT_EQ(std::vector<std::string>({"9", "10"}), result.results(opt));
+}
+
+TEST_F(TApp, DelimitedPositionals) {
+    std::vector<int> pair;
+    std::string rest;
+    app.add_option("pair", pair)->expected(2)->delimiter(',');
+    app.add_option("rest", rest);
+
+    args = {"1,2", "three"};
+    run();
+    EXPECT_EQ(std::vector<int>({1, 2}), pair);
+    EXPECT_EQ("three", rest);
+}
+
+TEST_F(TApp, DelimitedEnv) {
+    put_env("CLI11_TEST_ENV_TMP", "1,2,3");
+
+    std::vector<int> ids;
+    app.add_option("--ids", ids)->envname("CLI11_TEST_ENV_TMP")->delimiter(',');
+    run();
+    EXPECT_EQ(std::vector<int>({1, 2, 3}), ids);
+
+    unset_env("CLI11_TEST_ENV_TMP");
+}
+
 TEST_F(TApp, VectorFancyOpts) {
     std::vector<std::string> strvec;
     std::vector<std::string> answer{"mystring", "mystring2", "mystring3"};
@@ -1168,6 +1439,107 @@ TEST_F(TApp, ExcludesMixedFlags) {
     EXPECT_THROW(run(), CLI::ExcludesError);
 }
 
+TEST_F(TApp, MutuallyExclusiveFlags) {
+    CLI::Option *opt1 = app.add_flag("--opt1");
+    CLI::Option *opt2 = app.add_flag("--opt2");
+    CLI::Option *opt3 = app.add_flag("--opt3");
+    app.add_flag("--other");
+    app.mutually_exclusive({opt1, opt2, opt3});
+
+    run();
+
+    app.reset();
+    args = {"--opt2", "--other"};
+    run();
+
+    app.reset();
+    args = {"--opt2", "--opt2"};
+    run();
+
+    app.reset();
+    args = {"--opt3", "--opt1"};
+    EXPECT_THROW(run(), CLI::ExcludesError);
+
+    app.reset();
+    args = {"--other", "--opt2", "--opt3"};
+    EXPECT_THROW(run(), CLI::ExcludesError);
+
+    CLI::App other;
+    CLI::Option *outside = other.add_flag("--outside");
+    EXPECT_THROW(app.mutually_exclusive({opt1, outside}), CLI::IncorrectConstruction);
+}
+
+TEST_F(TApp, AddResultMarksGiven) {
+    int value = 0;
+    CLI::Option *value_opt = app.add_option("--value", value);
+    CLI::Option *one = app.add_flag("--one");
+    app.add_flag("--two")->needs(one);
+    app.add_flag("--three")->excludes(one);
+
+    // Values added directly are converted and checked like parsed ones
+    value_opt->add_result("5");
+    one->add_result("");
+    args = {"--two"};
+    run();
+    EXPECT_EQ(5, value);
+
+    app.reset();
+    one->add_result("");
+    args = {"--three"};
+    EXPECT_THROW(run(), CLI::ExcludesError);
+
+    // Cleared results are not given any more
+    app.reset();
+    one->add_result("");
+    one->clear();
+    run();
+    app.reset();
+    args = {"--two"};
+    one->add_result("");
+    one->clear();
+    EXPECT_THROW(run(), CLI::RequiresError);
+}
+
+TEST_F(TApp, RemoveOptionMovesGiven) {
+    CLI::Option *zero = app.add_flag("--zero");
+    CLI::Option *one = app.add_flag("--one");
+    CLI::Option *two = app.add_flag("--two");
+    one->excludes(two);
+
+    args = {"--one"};
+    run();
+
+    // --one is still given under its new id
+    EXPECT_TRUE(app.remove_option(zero));
+    two->add_result("");
+    args = {};
+    EXPECT_THROW(run(), CLI::ExcludesError);
+}
+
+TEST_F(TApp, RemoveOptionDropsConstraints) {
+    CLI::Option *one = app.add_flag("--one");
+    CLI::Option *two = app.add_flag("--two");
+    two->needs(one);
+    two->excludes(app.add_flag("--three"));
+
+    EXPECT_TRUE(app.remove_option(one));
+    args = {"--two"};
+    run();
+}
+
+TEST_F(TApp, NeedsParentOption) {
+    CLI::Option *top = app.add_flag("--top");
+    CLI::App *sub = app.add_subcommand("sub");
+    sub->add_flag("--low")->needs(top);
+
+    args = {"sub", "--low"};
+    EXPECT_THROW(run(), CLI::RequiresError);
+
+    app.reset();
+    args = {"--top", "sub", "--low"};
+    run();
+}
+
 TEST_F(TApp, NeedsMultiFlags) {
     CLI::Option *opt1 = app.add_flag("--opt1");
     CLI::Option *opt2 = app.add_flag("--opt2");
@@ -1328,6 +1700,101 @@ TEST_F(TApp, Env) {
     EXPECT_THROW(run(), CLI::RequiredError);
 }
 
+TEST_F(TApp, EnvSatisfiesNeeds) {
+
+    put_env("CLI11_TEST_ENV_TMP", "2");
+
+    // The environment is read before the constraints are checked, also for options added later
+    std::string second, third;
+    CLI::Option *first = app.add_flag("--first");
+    CLI::Option *second_opt = app.add_option("--second", second)->envname("CLI11_TEST_ENV_TMP");
+    CLI::Option *third_opt = app.add_option("--third", third)->envname("CLI11_TEST_ENV_OTHER");
+    first->needs(second_opt)->excludes(third_opt);
+
+    args = {"--first"};
+    run();
+
+    app.reset();
+    put_env("CLI11_TEST_ENV_OTHER", "3");
+    EXPECT_THROW(run(), CLI::ExcludesError);
+
+    unset_env("CLI11_TEST_ENV_TMP");
+    unset_env("CLI11_TEST_ENV_OTHER");
+}
+
+TEST_F(TApp, ResponseFiles) {
+    TempFile outer{"TestResponseOuter.txt"};
+    TempFile inner{"TestResponseInner.txt"};
+
+    {
+        std::ofstream out{outer};
+        out << "--one 1 'two words'\n@" << inner.c_str() << " last";
+    }
+    {
+        std::ofstream out{inner};
+        out << "  \"--three\" 3\n";
+    }
+
+    int one = 0, three = 0;
+    bool flag = false;
+    std::vector<std::string> posits;
+    app.add_option("--one", one);
+    app.add_option("--three", three);
+    app.add_flag("--flag", flag);
+    app.add_option("posits", posits);
+
+    // Off by default
+    args = {"@" + std::string(outer)};
+    run();
+    EXPECT_EQ(std::vector<std::string>({"@" + std::string(outer)}), posits);
+
+    app.reset();
+    app.response_files();
+    args = {"first", "@" + std::string(outer), "--flag"};
+    run();
+    EXPECT_EQ(1, one);
+    EXPECT_EQ(3, three);
+    EXPECT_TRUE(flag);
+    EXPECT_EQ(std::vector<std::string>({"first", "two words", "last"}), posits);
+
+    app.reset();
+    args = {"@TestResponseMissing.txt"};
+    EXPECT_THROW(run(), CLI::FileError);
+
+    // A file that includes itself, through another one
+    {
+        std::ofstream out{inner};
+        out << "@" << outer.c_str();
+    }
+    app.reset();
+    args = {"@" + std::string(inner)};
+    EXPECT_THROW(run(), CLI::FileError);
+}
+
+TEST_F(TApp, FrozenParsesRepeatedly) {
+
+    put_env("CLI11_TEST_ENV_TMP", "2");
+
+    int val = 1;
+    std::string first;
+    std::vector<std::string> rest;
+    app.add_option("--tmp", val)->envname("CLI11_TEST_ENV_TMP");
+    app.add_option("first", first);
+    app.add_option("rest", rest);
+    app.freeze();
+
+    for(int i = 0; i < 3; i++) {
+        app.reset();
+        args = {"one", "two", "three"};
+        run();
+        EXPECT_EQ(2, val);
+        EXPECT_EQ("one", first);
+        EXPECT_EQ(std::vector<std::string>({"two", "three"}), rest);
+    }
+
+    unset_env("CLI11_TEST_ENV_TMP");
+}
+
 TEST_F(TApp, RangeInt) {
     int x = 0;
     app.add_option("--one", x)->check(CLI::Range(3, 6));
@@ -1378,6 +1845,50 @@ TEST_F(TApp, RangeDouble) {
     run();
 }
 
+TEST_F(TApp, CheckValue) {
+    int x = 0;
+    std::vector<double> values;
+    CLI::Option *opt = app.add_option("--one", x)->check_value<int>(CLI::RangeValue(3, 6));
+    app.add_option("--values", values)->delimiter(',')->check_value<double>(CLI::RangeValue(1.0))->check_value<double>(
+        [](const double &value) { return value == 0.5 ? std::string("No halves") : std::string(); });
+
+    args = {"--one=5", "--values=0.25,1"};
+    run();
+    EXPECT_EQ(5, x);
+    EXPECT_EQ(std::vector<double>({0.25, 1.0}), values);
+
+    app.reset();
+    args = {"--one=7"};
+    EXPECT_THROW(run(), CLI::ValidationError);
+
+    app.reset();
+    args = {"--one=x"};
+    EXPECT_THROW(run(), CLI::ConversionError);
+
+    app.reset();
+    std::vector<std::string> input{"0.75,1.5", "--values"};
+    CLI::ParseStatus status = app.try_parse(input);
+    EXPECT_EQ(CLI::ParseStatus::Kind::Validation, status.get_kind());
+    EXPECT_EQ("--values: Value 1.5 not in range 0 to 1", status.what());
+
+    app.reset();
+    args = {"--values", "0.5"};
+    EXPECT_THROW(run(), CLI::ValidationError);
+
+    EXPECT_THROW(opt->check_value<double>(CLI::RangeValue(1.0)), CLI::IncorrectConstruction);
+    EXPECT_THROW(app.add_option("--call", [](CLI::results_t) { return true; })->check_value<int>(CLI::RangeValue(1)),
+                 CLI::IncorrectConstruction);
+}
+
+TEST_F(TApp, CheckValueLazy) {
+    CLI::Lazy<int> level;
+    app.add_option("--level", level)->check_value<int>(CLI::RangeValue(10));
+
+    args = {"--level", "11"};
+    run();
+    EXPECT_THROW(level.get(), CLI::ValidationError);
+}
+
 // Check to make sure progromatic access to left over is available
 TEST_F(TApp, AllowExtras) {
 
@@ -1479,6 +1990,22 @@ TEST_F(TApp, OrderedModifingTransforms) {
     EXPECT_EQ(val, std::vector<std::string>({"one12", "two12"}));
 }
 
+TEST_F(TApp, TransformsAndJoinParsedAgain) {
+    std::vector<std::string> val;
+    std::string str;
+    auto m = app.add_option("-m", val)->transform([](std::string x) { return x + "!"; });
+    auto s = app.add_option("--str", str)->join();
+
+    for(int i = 0; i < 20; ++i) {
+        args = {"-m" + std::to_string(i), "--str=one", "--str", std::to_string(i)};
+        run();
+        EXPECT_EQ(val, std::vector<std::string>({std::to_string(i) + "!"}));
+        EXPECT_EQ(str, "one\n" + std::to_string(i));
+        m->clear();
+        s->clear();
+    }
+}
+
 TEST_F(TApp, ThrowingTransform) {
     std::string val;
     auto m = app.add_option("-m,--mess", val);
@@ -1517,3 +2044,415 @@ TEST_F(TApp, CustomDoubleOption) {
     EXPECT_EQ(custom_opt.first, 12);
     EXPECT_DOUBLE_EQ(custom_opt.second, 1.5);
 }
+
+TEST_F(TApp, ViewCallbackOption) {
+
+    std::vector<std::string> seen;
+
+    auto opt = app.add_option_view("-v,--vals", [&seen](const CLI::ResultsView &vals) {
+        for(CLI::string_view val : vals)
+            seen.emplace_back(val);
+        return vals.size() == 3 && vals[1] == CLI::string_view("two");
+    });
+    opt->set_custom_option("STR", -1);
+
+    args = {"-v", "one", "two", "three"};
+    run();
+    EXPECT_EQ(std::vector<std::string>({"one", "two", "three"}), seen);
+
+    app.reset();
+    seen.clear();
+    opt->set_custom_option("STR", 1);
+    opt->join();
+
+    args = {"-v", "one", "-v", "two"};
+    EXPECT_THROW(run(), CLI::ConversionError);
+    EXPECT_EQ(std::vector<std::string>({"one\ntwo"}), seen);
+}
+
+TEST_F(TApp, ParseResultLeavesAppAlone) {
+
+    int val = 0;
+    std::vector<std::string> vals;
+    CLI::Option *flag = app.add_flag("-f,--flag");
+    CLI::Option *opt = app.add_option("-v,--val", val);
+    CLI::Option *posit = app.add_option("posit", vals);
+    CLI::App *sub = app.add_subcommand("sub");
+    CLI::Option *sflag = sub->add_flag("-s");
+    sub->allow_extras();
+
+    EXPECT_THROW(app.parse_result(std::vector<CLI::string_view>()), CLI::IncorrectConstruction);
+    app.freeze();
+
+    std::vector<CLI::string_view> input = {"-ff", "--val=3", "one", "two", "sub", "-s", "--extra"};
+    CLI::ParseResult result = app.parse_result(input);
+
+    EXPECT_EQ((size_t)2, result.count(flag));
+    EXPECT_EQ(std::vector<std::string>({"3"}), result.results(opt));
+    EXPECT_EQ(std::vector<std::string>({"one", "two"}), result.results(posit));
+    EXPECT_EQ(CLI::string_view("two"), result.results_view(posit)[1]);
+    EXPECT_TRUE(result.got_subcommand(sub));
+    EXPECT_EQ((size_t)1, result.count(sflag));
+    EXPECT_EQ(std::vector<CLI::App *>({sub}), result.get_subcommands());
+    EXPECT_EQ(std::vector<std::string>({"--extra"}), result.remaining(true));
+    EXPECT_EQ((size_t)5, result.parse_order().size());
+
+    // Nothing was stored in the App
+    EXPECT_EQ(0, val);
+    EXPECT_TRUE(vals.empty());
+    EXPECT_EQ((size_t)0, flag->count());
+    EXPECT_FALSE(sub->parsed());
+    EXPECT_TRUE(app.get_subcommands().empty());
+
+    EXPECT_THROW(app.parse_result(std::vector<CLI::string_view>({"--val"})), CLI::ArgumentMismatch);
+    EXPECT_THROW(app.parse_result(std::vector<CLI::string_view>({"--nope"})), CLI::ExtrasError);
+}
+
+TEST_F(TApp, ParseResultThreads) {
+
+    std::string val, value;
+    app.add_option("-v,--val", val);
+    CLI::Option *posit = app.add_option("posit", value);
+    app.freeze();
+
+    std::vector<std::thread> threads;
+    std::vector<int> matched(4, 0);
+    for(int t = 0; t < 4; t++) {
+        threads.emplace_back([this, t, posit, &matched]() {
+            for(int i = 0; i < 200; i++) {
+                std::string value = std::to_string(t * 1000 + i);
+                std::vector<CLI::string_view> input = {"-v", "x", value};
+                CLI::ParseResult result = app.parse_result(input);
+                if(result.results(posit) == std::vector<std::string>({value}))
+                    matched[static_cast<size_t>(t)]++;
+            }
+        });
+    }
+    for(std::thread &thread : threads)
+        thread.join();
+
+    EXPECT_EQ(std::vector<int>({200, 200, 200, 200}), matched);
+}
+
+TEST_F(TApp, PushParserFeedsOneByOne) {
+
+    std::vector<std::string> pair;
+    std::vector<std::string> vals;
+    std::string posit;
+    int flags = 0;
+    app.add_option("-p,--pair", pair)->expected(2);
+    app.add_option("-v,--vals", vals);
+    app.add_option("posit", posit);
+    app.add_flag("-f", flags);
+    CLI::App *sub = app.add_subcommand("sub");
+    int subflag = 0;
+    sub->add_flag("-s", subflag);
+
+    CLI::PushParser parser{app};
+    EXPECT_TRUE(parser.feed("pos"));
+    EXPECT_TRUE(parser.feed("-ff"));
+    EXPECT_FALSE(parser.feed("--pair"));
+    EXPECT_FALSE(parser.feed("one"));
+    EXPECT_TRUE(parser.feed("two"));
+    EXPECT_FALSE(parser.feed("-v"));
+    EXPECT_FALSE(parser.feed("a"));
+    EXPECT_FALSE(parser.feed("b"));
+    EXPECT_EQ((size_t)3, parser.pending());
+    EXPECT_TRUE(parser.feed("-f"));
+    EXPECT_TRUE(parser.feed("sub"));
+    EXPECT_TRUE(parser.feed("-s"));
+    EXPECT_FALSE(parser.needs_more());
+    parser.finish();
+
+    EXPECT_EQ(3, flags);
+    EXPECT_EQ(std::vector<std::string>({"one", "two"}), pair);
+    EXPECT_EQ(std::vector<std::string>({"a", "b"}), vals);
+    EXPECT_EQ("pos", posit);
+    EXPECT_TRUE(sub->parsed());
+    EXPECT_EQ(1, subflag);
+}
+
+TEST_F(TApp, PushParserFinishLikeParse) {
+
+    std::vector<std::string> vals;
+    std::string req;
+    app.add_option("-v,--vals", vals);
+    app.add_option("--req", req)->required();
+
+    CLI::PushParser parser{app};
+    EXPECT_TRUE(parser.feed("--req=x"));
+    EXPECT_FALSE(parser.feed("-v"));
+    EXPECT_FALSE(parser.feed("a"));
+    parser.finish();
+    EXPECT_EQ(std::vector<std::string>({"a"}), vals);
+    EXPECT_EQ("x", req);
+
+    app.reset();
+    CLI::PushParser missing{app};
+    EXPECT_FALSE(missing.feed("--req"));
+    EXPECT_THROW(missing.finish(), CLI::ArgumentMismatch);
+
+    app.reset();
+    CLI::PushParser extras{app};
+    EXPECT_TRUE(extras.feed("--req=y"));
+    EXPECT_TRUE(extras.feed("--nope"));
+    EXPECT_THROW(extras.finish(), CLI::ExtrasError);
+}
+
+TEST_F(TApp, LazyOptions) {
+    CLI::Lazy<int> number{7};
+    CLI::Lazy<std::vector<double>> values;
+    CLI::Lazy<std::string> unused;
+    CLI::Option *number_opt = app.add_option("-n,--number", number);
+    app.add_option("-v,--values", values);
+    app.add_option("--unused", unused);
+
+    EXPECT_TRUE(number_opt->get_lazy());
+    EXPECT_EQ(7, number.get());
+
+    args = {"-n", "bad", "-v", "1.5", "2"};
+    run();
+
+    // Nothing was converted by the parse
+    EXPECT_TRUE(number.given());
+    EXPECT_FALSE(number_opt->get_callback_run());
+    EXPECT_EQ(std::vector<double>({1.5, 2}), *values);
+    EXPECT_THROW(number.get(), CLI::ConversionError);
+    EXPECT_THROW(app.convert_lazy(), CLI::ConversionError);
+    EXPECT_EQ("", *unused);
+
+    app.reset();
+    args = {"--number=3"};
+    run();
+    app.convert_lazy();
+    EXPECT_TRUE(number_opt->get_callback_run());
+    EXPECT_EQ(3, number.get());
+    EXPECT_FALSE(values.given());
+    EXPECT_TRUE(values->empty());
+
+    app.reset();
+    args = {};
+    run();
+    EXPECT_EQ(7, *number);
+}
+
+TEST_F(TApp, TryParseReturnsErrors) {
+    int number = 0;
+    int level = 0;
+    std::string name;
+    app.add_option("-n,--number", number);
+    app.add_option("--level", level)->check(CLI::Range(10));
+    app.add_option("--name", name)->required();
+
+    // The status carries the same error the throwing parse reports
+    args = {"--name", "x", "-n", "4"};
+    std::vector<std::string> input{"4", "-n", "x", "--name"};
+    CLI::ParseStatus status = app.try_parse(input);
+    EXPECT_TRUE(status.ok());
+    EXPECT_TRUE(input.empty());
+    EXPECT_EQ(4, number);
+    EXPECT_EQ("", status.what());
+
+    struct Case {
+        std::vector<std::string> args;
+        CLI::ParseStatus::Kind kind;
+        CLI::ExitCodes code;
+    };
+    using Kind = CLI::ParseStatus::Kind;
+    std::vector<Case> cases{{{"-n", "4"}, Kind::Required, CLI::ExitCodes::RequiredError},
+                            {{"--name", "x", "extra"}, Kind::Extras, CLI::ExitCodes::ExtrasError},
+                            {{"--name", "x", "-n", "one"}, Kind::Conversion, CLI::ExitCodes::ConversionError},
+                            {{"--name", "x", "--level", "40"}, Kind::Validation, CLI::ExitCodes::ValidationError},
+                            {{"--name"}, Kind::ArgumentMismatchTypedAtLeast, CLI::ExitCodes::ArgumentMismatch},
+                            {{"-h"}, Kind::CallForHelp, CLI::ExitCodes::Success}};
+    for(const Case &c : cases) {
+        app.reset();
+        input = c.args;
+        std::reverse(std::begin(input), std::end(input));
+        status = app.try_parse(input);
+        EXPECT_FALSE(status.ok());
+        EXPECT_EQ(c.kind, status.get_kind());
+        EXPECT_EQ(static_cast<int>(c.code), status.get_exit_code());
+
+        // These are all found once every argument has been read, so none remain
+        EXPECT_TRUE(input.empty());
+
+        app.reset();
+        args = c.args;
+        try {
+            run();
+            ADD_FAILURE() << "parse did not throw";
+        } catch(const CLI::Error &e) {
+            EXPECT_EQ(e.get_name(), status.get_name());
+            EXPECT_EQ(std::string(e.what()), status.what());
+            EXPECT_EQ(e.get_exit_code(), status.get_exit_code());
+        }
+    }
+
+    // raise throws the real error type, and exit reports it like the error
+    app.reset();
+    input = {"-n"};
+    status = app.try_parse(input);
+    EXPECT_THROW(status.raise(), CLI::ArgumentMismatch);
+    std::stringstream out, err;
+    EXPECT_EQ(static_cast<int>(CLI::ExitCodes::ArgumentMismatch), app.exit(status, out, err));
+    EXPECT_NE(std::string::npos, err.str().find(status.what()));
+    EXPECT_EQ("", out.str());
+}
+
+TEST_F(TApp, TryParseSets) {
+    int value = 0;
+    std::string name;
+    app.add_set("--s", value, {1, 2});
+    app.add_set_ignore_case("--name", name, {"One", "Two"});
+
+    std::vector<std::string> input{"3", "--s"};
+    CLI::ParseStatus status = app.try_parse(input);
+    EXPECT_EQ(CLI::ParseStatus::Kind::Conversion, status.get_kind());
+    EXPECT_EQ(static_cast<int>(CLI::ExitCodes::ConversionError), status.get_exit_code());
+
+    app.reset();
+    input = {"x", "--s"};
+    status = app.try_parse(input);
+    EXPECT_EQ(CLI::ParseStatus::Kind::Conversion, status.get_kind());
+
+    app.reset();
+    input = {"three", "--name"};
+    status = app.try_parse(input);
+    EXPECT_EQ(CLI::ParseStatus::Kind::Conversion, status.get_kind());
+
+    app.reset();
+    input = {"TWO", "--name", "2", "--s"};
+    status = app.try_parse(input);
+    EXPECT_TRUE(status.ok());
+    EXPECT_EQ(2, value);
+    EXPECT_EQ("Two", name);
+}
+
+TEST_F(TApp, TryParseResult) {
+    CLI::Option *flag = app.add_flag("-f");
+    app.freeze();
+
+    CLI::ParseResult good = app.try_parse_result(std::vector<CLI::string_view>{"-f"});
+    EXPECT_TRUE(good.get_status().ok());
+    EXPECT_EQ(1u, good.count(flag));
+
+    CLI::ParseResult bad = app.try_parse_result(std::vector<CLI::string_view>{"-f", "other"});
+    EXPECT_EQ(CLI::ParseStatus::Kind::Extras, bad.get_status().get_kind());
+    EXPECT_THROW(app.parse_result(std::vector<CLI::string_view>{"-f", "other"}), CLI::ExtrasError);
+}
+
+TEST_F(TApp, ShortCircuitHelp) {
+    int number = 0;
+    std::vector<std::string> files;
+    app.add_option("-n,--number", number)->required();
+    app.add_option("-f,--files", files);
+    app.get_help_ptr()->short_circuit();
+
+    // Help wins over the errors both before and after it, and nothing is converted
+    args = {"-n", "one", "-f", "a", "b", "--help", "--nope", "-n"};
+    EXPECT_THROW(run(), CLI::CallForHelp);
+    EXPECT_EQ(0, number);
+    EXPECT_TRUE(files.empty());
+
+    app.reset();
+    args = {"-n", "one", "-h"};
+    std::vector<std::string> input{"-h", "one", "-n"};
+    CLI::ParseStatus status = app.try_parse(input);
+    EXPECT_EQ(CLI::ParseStatus::Kind::CallForHelp, status.get_kind());
+    EXPECT_EQ(1u, app.count("-n"));
+
+    // In a short flag cluster too
+    app.reset();
+    app.add_flag("-v");
+    args = {"-vh", "-n"};
+    EXPECT_THROW(run(), CLI::CallForHelp);
+}
+
+TEST_F(TApp, ParseVectorKeepsRemaining) {
+    int number = 0;
+    app.add_option("-n,--number", number);
+    app.add_flag("--version")->short_circuit();
+
+    std::vector<std::string> input{"3", "-n"};
+    app.parse(input);
+    EXPECT_TRUE(input.empty());
+    EXPECT_EQ(3, number);
+
+    // The arguments after a short circuit are given back, still reversed
+    app.reset();
+    input = {"-n", "--nope", "--version", "-nx"};
+    EXPECT_TRUE(app.try_parse(input).ok());
+    EXPECT_EQ(std::vector<std::string>({"-n", "--nope"}), input);
+}
+
+TEST_F(TApp, ShortCircuitOption) {
+    int number = 0;
+    bool version = false;
+    app.add_option("-n,--number", number)->required();
+    app.add_flag_function("--version", [&version](size_t) { version = true; })->short_circuit();
+    bool app_callback = false;
+    app.set_callback([&app_callback]() { app_callback = true; });
+
+    // Only the callback of the option runs, the requirements and the rest are skipped
+    args = {"--version", "--nope", "-n"};
+    run();
+    EXPECT_TRUE(version);
+    EXPECT_FALSE(app_callback);
+    EXPECT_EQ(1u, app.count("--version"));
+    EXPECT_EQ(0u, app.count("-n"));
+
+    app.reset();
+    version = false;
+    args = {"-n", "3"};
+    run();
+    EXPECT_FALSE(version);
+    EXPECT_TRUE(app_callback);
+    EXPECT_EQ(3, number);
+
+    // One argument at a time
+    app.reset();
+    version = false;
+    CLI::PushParser parser{app};
+    EXPECT_TRUE(parser.feed("--version"));
+    EXPECT_TRUE(parser.feed("--nope"));
+    EXPECT_FALSE(parser.needs_more());
+    parser.finish();
+    EXPECT_TRUE(version);
+}
+
+TEST_F(TApp, AbbreviatedLongOptions) {
+    int verbose = 0;
+    std::string version, vertical;
+    app.add_flag("--verbose", verbose);
+    app.add_option("--version", version);
+    app.add_option("--vertical,--VERT", vertical)->ignore_case();
+
+    // Abbreviations are off by default
+    args = {"--verb"};
+    EXPECT_THROW(run(), CLI::ExtrasError);
+
+    app.reset();
+    app.allow_abbreviations();
+    args = {"--verb", "--vers=2", "--verbo", "--VERTI", "up"};
+    run();
+    EXPECT_EQ(2, verbose);
+    EXPECT_EQ("2", version);
+    EXPECT_EQ("up", vertical);
+
+    // An ambiguous prefix is not an option
+    app.reset();
+    args = {"--ver", "1"};
+    EXPECT_THROW(run(), CLI::ExtrasError);
+
+    // Subcommands inherit the setting, and fall through to the parent
+    app.reset();
+    int count = 0;
+    CLI::App *sub = app.add_subcommand("sub");
+    sub->add_flag("--count", count);
+    sub->fallthrough();
+    args = {"sub", "--co", "--verb"};
+    run();
+    EXPECT_EQ(1, count);
+    EXPECT_EQ(1, verbose);
+}
@@ -0,0 +1,149 @@
+#include "gtest/gtest.h"
+#include "CLI/CLI.hpp"
+#include "CLI/Batch.hpp"
+#include <string>
+#include <vector>
+
+TEST(Batch, InputOrder) {
+    CLI::App app;
+    std::string value;
+    int count = 0;
+    CLI::Option *opt = app.add_option("-v,--value", value);
+    app.add_option("-c,--count", count);
+
+    std::vector<std::vector<std::string>> lines;
+    for(int i = 0; i < 1000; i++) {
+        if(i % 10 == 3)
+            lines.push_back({"--nope"});
+        else
+            lines.push_back({"-v", std::to_string(i), "--count=2"});
+    }
+
+    std::vector<CLI::BatchItem> items = CLI::parse_batch(app, lines, CLI::BatchOrder::Input, 4);
+
+    EXPECT_TRUE(app.get_frozen());
+    ASSERT_EQ(lines.size(), items.size());
+    for(size_t i = 0; i < items.size(); i++) {
+        EXPECT_EQ(i, items[i].index);
+        if(i % 10 == 3) {
+            EXPECT_FALSE(items[i].ok());
+            EXPECT_EQ(static_cast<int>(CLI::ExitCodes::ExtrasError), items[i].status.get_exit_code());
+            EXPECT_EQ("ExtrasError", items[i].status.get_name());
+            EXPECT_NE(std::string::npos, items[i].status.what().find("not expected"));
+        } else {
+            ASSERT_TRUE(items[i].ok());
+            EXPECT_EQ(std::vector<std::string>({std::to_string(i)}), items[i].result->results(opt));
+        }
+    }
+
+    // The App itself was not touched
+    EXPECT_EQ("", value);
+    EXPECT_EQ(0, count);
+}
+
+TEST(Batch, CompletionOrder) {
+    CLI::App app;
+    std::vector<std::string> values;
+    CLI::Option *opt = app.add_option("values", values);
+
+    const char *one[] = {"a", "b"};
+    const char *two[] = {"c"};
+    std::vector<std::vector<const char *>> lines;
+    for(int i = 0; i < 500; i++)
+        lines.push_back(i % 2 == 0 ? std::vector<const char *>(one, one + 2) : std::vector<const char *>(two, two + 1));
+
+    std::vector<CLI::BatchItem> items = CLI::parse_batch(app, lines, CLI::BatchOrder::Completion);
+
+    ASSERT_EQ(lines.size(), items.size());
+    std::vector<bool> seen(lines.size(), false);
+    for(const CLI::BatchItem &item : items) {
+        ASSERT_TRUE(item.ok());
+        EXPECT_FALSE(seen[item.index]);
+        seen[item.index] = true;
+        EXPECT_EQ(item.index % 2 == 0 ? (size_t)2 : (size_t)1, item.result->count(opt));
+    }
+}
+
+TEST(Batch, Empty) {
+    CLI::App app;
+    std::vector<std::vector<std::string>> lines;
+    EXPECT_TRUE(CLI::parse_batch(app, lines).empty());
+}
+
+TEST(Batch, ParallelClassification) {
+    std::vector<std::string> storage{"prog"};
+    for(int i = 0; i < 200000; i++) {
+        switch(i % 7) {
+        case 0:
+            storage.push_back("--name=" + std::to_string(i));
+            break;
+        case 1:
+            storage.push_back("-v");
+            break;
+        case 2:
+            storage.push_back("-n" + std::to_string(i));
+            break;
+        case 3:
+            storage.push_back("--");
+            break;
+        default:
+            storage.push_back("file" + std::to_string(i));
+        }
+    }
+    std::vector<const char *> argv;
+    for(const std::string &arg : storage)
+        argv.push_back(arg.c_str());
+
+    // The tokens match a sequential pass exactly
+    CLI::detail::TokenStream sequential{argv.size() - 1, argv.data() + 1};
+    CLI::detail::TokenStream parallel = CLI::detail::classify_parallel(argv.size() - 1, argv.data() + 1, 4);
+    ASSERT_EQ(sequential.size(), parallel.size());
+    for(size_t i = 0; i < sequential.size(); i++) {
+        EXPECT_EQ(sequential[i].data, parallel[i].data);
+        EXPECT_EQ(sequential[i].kind, parallel[i].kind);
+        EXPECT_EQ(sequential[i].name_size, parallel[i].name_size);
+        EXPECT_EQ(sequential[i].value_begin, parallel[i].value_begin);
+    }
+
+    // And so does the parse
+    CLI::App app;
+    std::vector<std::string> names, files;
+    int verbose = 0;
+    app.add_option("-n,--name", names);
+    app.add_flag("-v", verbose);
+    app.add_option("files", files);
+    CLI::ParseStatus status = CLI::try_parse_parallel(app, static_cast<int>(argv.size()), argv.data(), 4);
+    ASSERT_TRUE(status.ok()) << status.what();
+    std::vector<std::string> parallel_names = names, parallel_files = files;
+
+    app.reset();
+    names.clear();
+    files.clear();
+    app.parse(static_cast<int>(argv.size()), argv.data());
+    EXPECT_EQ(names, parallel_names);
+    EXPECT_EQ(files, parallel_files);
+    EXPECT_FALSE(names.empty());
+    EXPECT_FALSE(files.empty());
+
+    app.reset();
+    std::vector<const char *> bad{"prog", "--nope"};
+    EXPECT_THROW(CLI::parse_parallel(app, 2, bad.data()), CLI::ExtrasError);
+}
+
+TEST(Batch, ParallelSetsName) {
+    std::vector<const char *> argv{"prog", "-v"};
+    int verbose = 0;
+
+    CLI::App serial;
+    serial.add_flag("-v", verbose);
+    serial.freeze();
+    ASSERT_TRUE(serial.try_parse(static_cast<int>(argv.size()), argv.data()).ok());
+
+    CLI::App parallel;
+    parallel.add_flag("-v", verbose);
+    parallel.freeze();
+    ASSERT_TRUE(CLI::try_parse_parallel(parallel, static_cast<int>(argv.size()), argv.data()).ok());
+
+    EXPECT_EQ("prog", serial.get_name());
+    EXPECT_EQ(serial.get_name(), parallel.get_name());
+}
@@ -418,3 +418,57 @@ TEST_F(TApp, GetOptionList) {
     EXPECT_EQ(opt_list.at(1), flag);
     EXPECT_EQ(opt_list.at(2), opt);
 }
+
+TEST_F(TApp, FrozenAppCannotChange) {
+    CLI::Option *opt = app.add_flag("-c,--count");
+    CLI::App *sub = app.add_subcommand("sub");
+    app.freeze();
+
+    EXPECT_TRUE(app.get_frozen());
+    EXPECT_TRUE(sub->get_frozen());
+    EXPECT_THROW(app.add_flag("--other"), CLI::IncorrectConstruction);
+    EXPECT_THROW(app.remove_option(opt), CLI::IncorrectConstruction);
+    EXPECT_THROW(app.add_subcommand("other"), CLI::IncorrectConstruction);
+    EXPECT_THROW(sub->add_flag("--other"), CLI::IncorrectConstruction);
+    EXPECT_THROW(sub->set_name("other"), CLI::IncorrectConstruction);
+    EXPECT_THROW(app.allow_extras(), CLI::IncorrectConstruction);
+    EXPECT_THROW(app.allow_ini_extras(), CLI::IncorrectConstruction);
+    EXPECT_THROW(app.prefix_command(), CLI::IncorrectConstruction);
+    EXPECT_THROW(app.response_files(), CLI::IncorrectConstruction);
+    EXPECT_THROW(app.allow_abbreviations(), CLI::IncorrectConstruction);
+    EXPECT_THROW(app.require_subcommand(), CLI::IncorrectConstruction);
+    EXPECT_THROW(app.require_subcommand(1), CLI::IncorrectConstruction);
+    EXPECT_THROW(app.require_subcommand(1, 2), CLI::IncorrectConstruction);
+    EXPECT_THROW(sub->fallthrough(), CLI::IncorrectConstruction);
+    EXPECT_THROW(sub->ignore_case(), CLI::IncorrectConstruction);
+    EXPECT_FALSE(app.get_allow_extras());
+    EXPECT_EQ(0u, app.get_require_subcommand_min());
+}
+
+TEST_F(TApp, FrozenOptionsCannotChange) {
+    std::vector<int> values;
+    CLI::Option *flag = app.add_flag("-c,--count");
+    CLI::Option *opt = app.add_option("--values", values);
+    CLI::Option *other = app.add_flag("--other");
+    app.freeze();
+
+    EXPECT_THROW(opt->required(), CLI::IncorrectConstruction);
+    EXPECT_THROW(opt->mandatory(), CLI::IncorrectConstruction);
+    EXPECT_THROW(opt->envname("CLI11_TEST_ENV_TMP"), CLI::IncorrectConstruction);
+    EXPECT_THROW(opt->expected(2), CLI::IncorrectConstruction);
+    EXPECT_THROW(opt->needs(flag), CLI::IncorrectConstruction);
+    EXPECT_THROW(opt->excludes(other), CLI::IncorrectConstruction);
+    EXPECT_THROW(flag->ignore_case(), CLI::IncorrectConstruction);
+    EXPECT_THROW(opt->delimiter(','), CLI::IncorrectConstruction);
+    EXPECT_THROW(flag->short_circuit(), CLI::IncorrectConstruction);
+    EXPECT_THROW(opt->lazy(), CLI::IncorrectConstruction);
+    EXPECT_THROW(app.mutually_exclusive({flag, other}), CLI::IncorrectConstruction);
+
+    // Nothing was changed by the failed calls
+    EXPECT_FALSE(opt->get_required());
+    EXPECT_FALSE(flag->get_ignore_case());
+    EXPECT_EQ(0, opt->get_delimiter());
+    EXPECT_TRUE(app.try_parse(args).ok());
+    args = {"--COUNT"};
+    EXPECT_EQ(CLI::ParseStatus::Kind::Extras, app.try_parse(args).get_kind());
+}
@@ -1,10 +1,13 @@
 #include "app_helper.hpp"
 
+#include <clocale>
 #include <cstdio>
 #include <fstream>
 #include <cstdint>
 #include <string>
 #include <complex>
+#include <cmath>
+#include <limits>
 
 TEST(Split, SimpleByToken) {
     auto out = CLI::detail::split("one.two.three", '.');
@@ -155,6 +158,22 @@ TEST(Validators, PathNotExistsDir) {
     EXPECT_NE(CLI::ExistingPath(mydir), "");
 }
 
+TEST(Validators, RangeCheck) {
+    CLI::RangeCheck<int> range = CLI::RangeValue(0, 100);
+    EXPECT_TRUE(range(50).empty());
+    EXPECT_EQ("Value -1 not in range 0 to 100", range(-1));
+
+    std::vector<int> values{0, 100, 50, 101, -5};
+    EXPECT_EQ(3u, range.first_invalid(values.data(), values.size()));
+    EXPECT_EQ(3u, range.first_invalid(values.data(), 3));
+
+    std::function<std::string(const std::string &)> validator = CLI::Range(0, 100);
+    EXPECT_TRUE(validator("50").empty());
+    EXPECT_EQ("Value 150 not in range 0 to 100", validator("150"));
+    EXPECT_TRUE(validator("many").empty());
+    EXPECT_FALSE(CLI::Range(2.5)("3").empty());
+}
+
 // Yes, this is testing an app_helper :)
 TEST(AppHelper, TempfileCreated) {
     std::string name = "TestFileNotUsed.txt";
@@ -208,6 +227,104 @@ TEST(Split, StringList) {
     EXPECT_EQ(std::vector<std::string>({"one"}), CLI::detail::split_names("one"));
 }
 
+TEST(NameIndex, FindAndRemove) {
+    int one, two;
+    CLI::detail::NameIndex<int *> index;
+    index.add("one", false, &one);
+    index.add("Two", true, &two);
+
+    EXPECT_EQ(&one, index.find("one"));
+    EXPECT_EQ(nullptr, index.find("One"));
+    EXPECT_EQ(&two, index.find("two"));
+    EXPECT_EQ(&two, index.find("TWO"));
+    EXPECT_EQ(nullptr, index.find("three"));
+
+    index.remove("Two", &two);
+    EXPECT_EQ(nullptr, index.find("two"));
+}
+
+TEST(NameIndex, Conflicts) {
+    int one, two;
+    CLI::detail::NameIndex<int *> index;
+    index.add("one", false, &one);
+
+    EXPECT_EQ(&one, index.conflict("one", false, &two));
+    EXPECT_EQ(nullptr, index.conflict("one", false, &one));
+    EXPECT_EQ(nullptr, index.conflict("One", false, &two));
+    EXPECT_EQ(&one, index.conflict("One", true, &two));
+}
+
+TEST(NameIndex, CaseInsensitiveAddedLater) {
+    int one, two, three;
+    CLI::detail::NameIndex<int *> index;
+    index.add("One", false, &one);
+    index.add("two", false, &two);
+    EXPECT_EQ(nullptr, index.find("one"));
+    EXPECT_EQ(&two, index.conflict("TWO", true, &three));
+
+    index.add("THREE", true, &three);
+    EXPECT_EQ(&one, index.find("One"));
+    EXPECT_EQ(nullptr, index.find("one"));
+    EXPECT_EQ(&two, index.find("two"));
+    EXPECT_EQ(&three, index.find("three"));
+    EXPECT_EQ(&one, index.conflict("ONE", true, &three));
+}
+
+TEST(CharIndex, FindAndConflicts) {
+    int a, b, c;
+    CLI::detail::CharIndex<int *> index;
+    index.add('a', false, &a);
+    index.add('B', true, &b);
+
+    EXPECT_EQ(&a, index.find('a'));
+    EXPECT_EQ(nullptr, index.find('A'));
+    EXPECT_EQ(&b, index.find('b'));
+    EXPECT_EQ(&b, index.find('B'));
+
+    EXPECT_EQ(nullptr, index.conflict('A', false, &c));
+    EXPECT_EQ(&a, index.conflict('A', true, &c));
+    EXPECT_EQ(&b, index.conflict('b', false, &c));
+
+    index.remove('B', &b);
+    EXPECT_EQ(nullptr, index.find('b'));
+}
+
+TEST(PrefixTrie, UniquePrefixes) {
+    int verbose, version, output;
+    CLI::detail::PrefixTrie<int *> trie;
+    trie.add("verbose", false, &verbose);
+    trie.add("verbosity", false, &verbose);
+    trie.add("version", false, &version);
+    trie.add("Output", true, &output);
+
+    bool ambiguous;
+    auto find = [&](const std::string &prefix) { return trie.find(prefix.data(), prefix.size(), ambiguous); };
+
+    EXPECT_EQ(nullptr, find("ver"));
+    EXPECT_TRUE(ambiguous);
+    EXPECT_EQ(&verbose, find("verb"));
+    EXPECT_FALSE(ambiguous);
+    EXPECT_EQ(&verbose, find("verbosit"));
+    EXPECT_EQ(&version, find("vers"));
+    EXPECT_EQ(&version, find("version"));
+    EXPECT_EQ(nullptr, find("versions"));
+    EXPECT_FALSE(ambiguous);
+    EXPECT_EQ(nullptr, find("Verb"));
+    EXPECT_EQ(&output, find("oUT"));
+    EXPECT_EQ(nullptr, find("x"));
+    EXPECT_FALSE(ambiguous);
+
+    // A case insensitive name can make a prefix ambiguous too
+    trie.add("VERBAL", true, &output);
+    EXPECT_EQ(nullptr, find("verb"));
+    EXPECT_TRUE(ambiguous);
+    EXPECT_EQ(&verbose, find("verbo"));
+
+    trie.clear();
+    EXPECT_EQ(nullptr, find("verb"));
+    EXPECT_FALSE(ambiguous);
+}
+
 TEST(RegEx, Shorts) {
     std::string name, value;
 
@@ -278,6 +395,150 @@ TEST(RegEx, SplittingNew) {
     EXPECT_THROW(std::tie(shorts, longs, pname) = CLI::detail::get_names({"one", "two"}), CLI::BadNameString);
 }
 
+TEST(Classify, Kinds) {
+    using CLI::detail::Classifer;
+    auto kind = [](std::string arg) { return CLI::detail::classify(arg.data(), arg.size()).kind; };
+
+    EXPECT_EQ(Classifer::POSITIONAL_MARK, kind("--"));
+    EXPECT_EQ(Classifer::LONG, kind("--a"));
+    EXPECT_EQ(Classifer::LONG, kind("--some=thing"));
+    EXPECT_EQ(Classifer::SHORT, kind("-a"));
+    EXPECT_EQ(Classifer::SHORT, kind("-simple"));
+    EXPECT_EQ(Classifer::NONE, kind("-"));
+    EXPECT_EQ(Classifer::NONE, kind("---a"));
+    EXPECT_EQ(Classifer::NONE, kind("-1"));
+    EXPECT_EQ(Classifer::NONE, kind("something"));
+    EXPECT_EQ(Classifer::NONE, kind(""));
+}
+
+TEST(Classify, Spans) {
+    std::string arg = "--some=thing";
+    CLI::detail::Token token = CLI::detail::classify(arg.data(), arg.size());
+    EXPECT_EQ("some", token.name());
+    EXPECT_EQ("thing", token.value());
+    EXPECT_TRUE(token.has_value);
+
+    arg = "--some";
+    token = CLI::detail::classify(arg.data(), arg.size());
+    EXPECT_EQ("some", token.name());
+    EXPECT_EQ("", token.value());
+    EXPECT_FALSE(token.has_value);
+
+    arg = "-simple";
+    token = CLI::detail::classify(arg.data(), arg.size());
+    EXPECT_EQ("s", token.name());
+    EXPECT_EQ("imple", token.value());
+}
+
+TEST(TokenStream, ReversedInput) {
+    std::vector<std::string> args = {"three", "-2", "--one"};
+    CLI::detail::TokenStream tokens{args};
+
+    ASSERT_EQ(3u, tokens.size());
+    EXPECT_EQ("--one", tokens.front().str());
+    tokens.pop_front();
+    EXPECT_EQ("-2", tokens.front().str());
+    tokens.pop_front();
+    tokens.push_front("-x");
+    EXPECT_EQ(CLI::detail::Classifer::SHORT, tokens.front().kind);
+    EXPECT_EQ(2u, tokens.size());
+    tokens.pop_front();
+    EXPECT_EQ("three", tokens.front().str());
+    tokens.pop_front();
+    EXPECT_TRUE(tokens.empty());
+}
+
+TEST(TokenStream, ArgvInPlace) {
+    const char *argv[] = {"--one=1", "-t2", "three"};
+    CLI::detail::TokenStream tokens{3, argv};
+
+    ASSERT_EQ(3u, tokens.size());
+    EXPECT_EQ(argv[0], tokens.front().data);
+    EXPECT_EQ(CLI::string_view("one"), tokens.front().name_view());
+    EXPECT_EQ(CLI::string_view("1"), tokens.front().value_view());
+    tokens.pop_front();
+    EXPECT_EQ(CLI::string_view("2"), tokens.front().value_view());
+    tokens.pop_front();
+    EXPECT_EQ(CLI::string_view("three"), tokens.front().text());
+}
+
+TEST(ResultArena, AddViewClear) {
+    CLI::detail::ResultArena arena;
+    CLI::detail::ResultSpan one = arena.add("one");
+    CLI::detail::ResultSpan empty = arena.add("");
+    CLI::detail::ResultSpan two = arena.add(std::string(100, 'x'));
+
+    EXPECT_EQ(CLI::string_view("one"), arena.view(one));
+    EXPECT_EQ("", arena.str(empty));
+    EXPECT_EQ(std::string(100, 'x'), arena.str(two));
+    EXPECT_EQ(103u, arena.size());
+
+    std::vector<CLI::detail::ResultSpan> spans = {one, two};
+    EXPECT_EQ(std::vector<std::string>({"one", std::string(100, 'x')}), arena.strs(spans.data(), spans.data() + 2));
+
+    arena.clear();
+    EXPECT_EQ(0u, arena.size());
+}
+
+TEST(ResultArena, Replace) {
+    CLI::detail::ResultArena arena;
+    CLI::detail::ResultSpan value = arena.add("value");
+    CLI::detail::ResultSpan other = arena.add("other");
+
+    arena.replace(value, "new");
+    EXPECT_EQ("new", arena.str(value));
+    EXPECT_EQ("other", arena.str(other));
+    EXPECT_EQ(10u, arena.size());
+
+    arena.replace(value, "longer value");
+    EXPECT_EQ("longer value", arena.str(value));
+    EXPECT_EQ("other", arena.str(other));
+}
+
+TEST(OptionBits, Searches) {
+    CLI::detail::OptionBits given(10);
+    given.set(3);
+    given.set(70);
+    given.set(130);
+
+    EXPECT_TRUE(given.test(70));
+    EXPECT_FALSE(given.test(71));
+    EXPECT_FALSE(given.test(1000));
+    EXPECT_EQ(3u, given.find_next());
+    EXPECT_EQ(70u, given.find_next(4));
+    EXPECT_EQ(130u, given.find_next(71));
+    EXPECT_EQ(CLI::detail::OptionBits::npos, given.find_next(131));
+
+    CLI::detail::OptionBits needs;
+    needs.set(3);
+    needs.set(64);
+    needs.set(130);
+    EXPECT_EQ(64u, needs.first_andn(given));
+    EXPECT_EQ(3u, needs.first_and(given));
+    EXPECT_EQ(130u, needs.first_and(given, 4));
+
+    given.clear();
+    EXPECT_TRUE(given.none());
+    EXPECT_EQ(CLI::detail::OptionBits::npos, needs.first_and(given));
+}
+
+TEST(StringView, Basics) {
+    std::string str = "one=two";
+    CLI::string_view view{str};
+
+    EXPECT_EQ(7u, view.size());
+    EXPECT_EQ(3u, view.find('='));
+    EXPECT_EQ(CLI::string_view::npos, view.find('x'));
+    EXPECT_EQ(CLI::string_view("two"), view.substr(4));
+    EXPECT_NE(CLI::string_view("one"), view);
+    EXPECT_TRUE(CLI::string_view("abc") < CLI::string_view("abd"));
+    EXPECT_TRUE(CLI::string_view().empty());
+
+    std::stringstream out;
+    out << view.substr(0, 3);
+    EXPECT_EQ("one", out.str());
+}
+
 TEST(String, ToLower) { EXPECT_EQ("one and two", CLI::detail::to_lower("one And TWO")); }
 
 TEST(Join, Forward) {
@@ -325,6 +586,23 @@ TEST(SplitUp, BadStrings) {
     EXPECT_EQ(oput, result);
 }
 
+TEST(SplitUp, ViewsMatchSplitUp) {
+    std::vector<std::string> inputs = {R"(one "two three")",
+                                       R"("one 'two three'")",
+                                       R"(  one  "  two three" )",
+                                       R"(  one  "  two three )",
+                                       R"(  one  '  two three )",
+                                       "one\ttwo\n'three'four \"\" five",
+                                       ""};
+    for(const std::string &input : inputs) {
+        std::vector<std::string> result;
+        CLI::detail::split_up_views(input.data(), input.size(), [&result](const char *data, size_t size) {
+            result.emplace_back(data, size);
+        });
+        EXPECT_EQ(CLI::detail::split_up(input), result);
+    }
+}
+
 TEST(Types, TypeName) {
     std::string int_name = CLI::detail::type_name<int>();
     EXPECT_EQ("INT", int_name);
@@ -401,6 +679,155 @@ TEST(Types, LexicalCastDouble) {
     EXPECT_FALSE(CLI::detail::lexical_cast(extra_input, x));
 }
 
+TEST(Types, LexicalCastNumberForms) {
+    int x;
+    EXPECT_TRUE(CLI::detail::lexical_cast("0x1F", x));
+    EXPECT_EQ(31, x);
+    EXPECT_TRUE(CLI::detail::lexical_cast("017", x));
+    EXPECT_EQ(15, x);
+    EXPECT_TRUE(CLI::detail::lexical_cast(" +42", x));
+    EXPECT_EQ(42, x);
+    EXPECT_TRUE(CLI::detail::lexical_cast("-0X10", x));
+    EXPECT_EQ(-16, x);
+    EXPECT_TRUE(CLI::detail::lexical_cast("0", x));
+    EXPECT_EQ(0, x);
+    EXPECT_FALSE(CLI::detail::lexical_cast("08", x));
+    EXPECT_FALSE(CLI::detail::lexical_cast("0x", x));
+    EXPECT_FALSE(CLI::detail::lexical_cast("+-1", x));
+    EXPECT_FALSE(CLI::detail::lexical_cast("1 ", x));
+    EXPECT_FALSE(CLI::detail::lexical_cast("", x));
+
+    long long big;
+    EXPECT_TRUE(CLI::detail::lexical_cast("-9223372036854775808", big));
+    EXPECT_EQ(std::numeric_limits<long long>::min(), big);
+    EXPECT_FALSE(CLI::detail::lexical_cast("9223372036854775808", big));
+
+    unsigned int u;
+    EXPECT_FALSE(CLI::detail::lexical_cast(" -5", u));
+    EXPECT_TRUE(CLI::detail::lexical_cast("0xffffffff", u));
+    EXPECT_EQ(0xffffffffu, u);
+
+    std::uint8_t small;
+    EXPECT_EQ(CLI::detail::NumberError::OutOfRange, CLI::detail::parse_number("300", small));
+    EXPECT_EQ(CLI::detail::NumberError::Invalid, CLI::detail::parse_number("3x", small));
+    EXPECT_EQ(CLI::detail::NumberError::None, CLI::detail::parse_number("255", small));
+    EXPECT_EQ(255, small);
+
+    double d;
+    EXPECT_TRUE(CLI::detail::lexical_cast("  -2.5e1", d));
+    EXPECT_DOUBLE_EQ(-25.0, d);
+    EXPECT_TRUE(CLI::detail::lexical_cast("0x1p3", d));
+    EXPECT_DOUBLE_EQ(8.0, d);
+    EXPECT_TRUE(CLI::detail::lexical_cast("-inf", d));
+    EXPECT_TRUE(std::isinf(d) && d < 0);
+    EXPECT_TRUE(CLI::detail::lexical_cast("+.5", d));
+    EXPECT_DOUBLE_EQ(0.5, d);
+    EXPECT_FALSE(CLI::detail::lexical_cast("--1", d));
+    EXPECT_FALSE(CLI::detail::lexical_cast("1e", d));
+    EXPECT_EQ(CLI::detail::NumberError::OutOfRange, CLI::detail::parse_number("1e400", d));
+}
+
+TEST(Types, LexicalCastUnderflow) {
+    // Values too small for the type become zero or a denormal, with or without from_chars
+    float f = 1;
+    EXPECT_TRUE(CLI::detail::lexical_cast("1e-50", f));
+    EXPECT_EQ(0.0f, f);
+    EXPECT_TRUE(CLI::detail::lexical_cast("1e-310", f));
+    EXPECT_EQ(0.0f, f);
+    EXPECT_TRUE(CLI::detail::lexical_cast("4.9e-324", f));
+    EXPECT_EQ(0.0f, f);
+    EXPECT_TRUE(CLI::detail::lexical_cast("-0x1p-200", f));
+    EXPECT_EQ(0.0f, f);
+    EXPECT_EQ(CLI::detail::NumberError::OutOfRange, CLI::detail::parse_number("1e50", f));
+
+    double d = 1;
+    EXPECT_TRUE(CLI::detail::lexical_cast("1e-310", d));
+    EXPECT_GT(d, 0.0);
+    EXPECT_LT(d, std::numeric_limits<double>::min());
+    EXPECT_TRUE(CLI::detail::lexical_cast("4.9e-324", d));
+    EXPECT_EQ(std::numeric_limits<double>::denorm_min(), d);
+
+    // Also beyond what a long double can hold
+    d = 1;
+    EXPECT_TRUE(CLI::detail::lexical_cast("1e-400", d));
+    EXPECT_EQ(0.0, d);
+    d = 1;
+    EXPECT_TRUE(CLI::detail::lexical_cast("-0.00001e-99999", d));
+    EXPECT_EQ(0.0, d);
+    EXPECT_TRUE(std::signbit(d));
+    d = 1;
+    EXPECT_TRUE(CLI::detail::lexical_cast("0x0.001p-99999", d));
+    EXPECT_EQ(0.0, d);
+    EXPECT_EQ(CLI::detail::NumberError::OutOfRange, CLI::detail::parse_number("1e99999", d));
+    EXPECT_EQ(CLI::detail::NumberError::OutOfRange, CLI::detail::parse_number("0.001e99999", d));
+    EXPECT_EQ(CLI::detail::NumberError::OutOfRange, CLI::detail::parse_number("0x1p99999", d));
+}
+
+TEST(Types, LexicalCastFloatHex) {
+    double d = 1;
+    EXPECT_TRUE(CLI::detail::lexical_cast("0x.8p1", d));
+    EXPECT_DOUBLE_EQ(1.0, d);
+    EXPECT_TRUE(CLI::detail::lexical_cast("-0X1A", d));
+    EXPECT_DOUBLE_EQ(-26.0, d);
+    EXPECT_FALSE(CLI::detail::lexical_cast("0xinf", d));
+    EXPECT_FALSE(CLI::detail::lexical_cast("0xnan", d));
+    EXPECT_FALSE(CLI::detail::lexical_cast("0x", d));
+    EXPECT_FALSE(CLI::detail::lexical_cast("0x1p", d));
+    EXPECT_FALSE(CLI::detail::lexical_cast("0xp1", d));
+    EXPECT_FALSE(CLI::detail::lexical_cast("0x-1", d));
+}
+
+TEST(Types, LexicalCastFloatLocale) {
+    // A locale with a decimal comma, if there is one, does not change how numbers are read
+    std::string previous = std::setlocale(LC_ALL, nullptr);
+    for(const char *name : {"de_DE.UTF-8", "de_DE.utf8", "de_DE", "fr_FR.UTF-8", "German"}) {
+        if(std::setlocale(LC_ALL, name) == nullptr)
+            continue;
+        double d = 0;
+        EXPECT_TRUE(CLI::detail::lexical_cast("1.5", d));
+        EXPECT_DOUBLE_EQ(1.5, d);
+        EXPECT_FALSE(CLI::detail::lexical_cast("1,5", d));
+        EXPECT_EQ(CLI::detail::NumberError::None, CLI::detail::parse_float_strtold(CLI::string_view("2.25"), d));
+        EXPECT_DOUBLE_EQ(2.25, d);
+        EXPECT_EQ(CLI::detail::NumberError::Invalid, CLI::detail::parse_float_strtold(CLI::string_view("2,25"), d));
+        break;
+    }
+    std::setlocale(LC_ALL, previous.c_str());
+}
+
+TEST(Types, LexicalCastLongDecimals) {
+    unsigned long long big;
+    EXPECT_TRUE(CLI::detail::lexical_cast("18446744073709551615", big));
+    EXPECT_EQ(std::numeric_limits<unsigned long long>::max(), big);
+    EXPECT_TRUE(CLI::detail::lexical_cast("1234567812345678", big));
+    EXPECT_EQ(1234567812345678ULL, big);
+    EXPECT_TRUE(CLI::detail::lexical_cast("9", big));
+    EXPECT_EQ(9u, big);
+    EXPECT_EQ(CLI::detail::NumberError::OutOfRange, CLI::detail::parse_number("18446744073709551616", big));
+    EXPECT_FALSE(CLI::detail::lexical_cast("12345678x", big));
+    EXPECT_FALSE(CLI::detail::lexical_cast("1234:678", big));
+    EXPECT_FALSE(CLI::detail::lexical_cast("1234567/", big));
+
+    int small;
+    EXPECT_TRUE(CLI::detail::lexical_cast("-2147483648", small));
+    EXPECT_EQ(std::numeric_limits<int>::min(), small);
+}
+
+TEST(Types, LexicalCastAll) {
+    std::vector<std::string> input{"1", "22", "-333", "4444"};
+    std::vector<int> output{7, 7};
+    EXPECT_EQ(input.size(), CLI::detail::lexical_cast_all(input, output));
+    EXPECT_EQ(std::vector<int>({1, 22, -333, 4444}), output);
+
+    input[2] = "three";
+    EXPECT_EQ(2u, CLI::detail::lexical_cast_all(input, output));
+    EXPECT_EQ(std::vector<int>({1, 22, -333, 4444}), output);
+
+    std::vector<double> values;
+    EXPECT_EQ(2u, CLI::detail::lexical_cast_all(std::vector<std::string>{"1.5", "-2"}, values));
+    EXPECT_EQ(std::vector<double>({1.5, -2.0}), values);
+}
+
 TEST(Types, LexicalCastString) {
     std::string input = "one";
     std::string output;
@@ -408,6 +835,40 @@ TEST(Types, LexicalCastString) {
     EXPECT_EQ(input, output);
 }
 
+/// A type with both a parser and a stream operator, recording which one read it
+struct TaggedId {
+    int value{0};
+    bool from_parser{false};
+};
+
+std::istream &operator>>(std::istream &in, TaggedId &id) { return in >> id.value; }
+
+namespace CLI {
+template <> struct parser<TaggedId> {
+    static bool parse(string_view input, TaggedId &output) {
+        if(input.size() < 2 || input[0] != '#' || !detail::lexical_cast(input.substr(1), output.value))
+            return false;
+        output.from_parser = true;
+        return true;
+    }
+};
+} // namespace CLI
+
+TEST(Types, LexicalCastParser) {
+    EXPECT_TRUE(CLI::detail::has_parser<TaggedId>::value);
+    EXPECT_FALSE(CLI::detail::has_parser<std::complex<double>>::value);
+
+    TaggedId id;
+    EXPECT_TRUE(CLI::detail::lexical_cast("#42", id));
+    EXPECT_EQ(42, id.value);
+    EXPECT_TRUE(id.from_parser);
+    EXPECT_FALSE(CLI::detail::lexical_cast("42", id));
+
+    std::vector<TaggedId> ids;
+    EXPECT_EQ(2u, CLI::detail::lexical_cast_all(std::vector<std::string>{"#1", "#2"}, ids));
+    EXPECT_EQ(2, ids[1].value);
+}
+
 TEST(Types, LexicalCastParsable) {
     std::string input = "(4.2,7.3)";
     std::string fail_input = "4.2,7.3";
@@ -195,6 +195,44 @@ TEST_F(TApp, IniNotRequired) {
     EXPECT_EQ(3, three);
 }
 
+TEST_F(TApp, IniEnvPrecedence) {
+
+    TempFile tmpini{"TestIniTmp.ini"};
+
+    app.set_config("--config", tmpini);
+
+    {
+        std::ofstream out{tmpini};
+        out << "[default]" << std::endl;
+        out << "one=10" << std::endl;
+        out << "two=20" << std::endl;
+    }
+
+    put_env("CLI11_TEST_ENV_ONE", "100");
+    put_env("CLI11_TEST_ENV_TWO", "200");
+    put_env("CLI11_TEST_ENV_THREE", "300");
+
+    int one = 0, two = 0, three = 0, four = 4;
+    app.add_option("--one", one)->envname("CLI11_TEST_ENV_ONE");
+    app.add_option("--two", two)->envname("CLI11_TEST_ENV_TWO");
+    app.add_option("--three", three)->envname("CLI11_TEST_ENV_THREE");
+    app.add_option("--four", four)->envname("CLI11_TEST_ENV_FOUR");
+
+    args = {"--one=1"};
+
+    run();
+
+    unset_env("CLI11_TEST_ENV_ONE");
+    unset_env("CLI11_TEST_ENV_TWO");
+    unset_env("CLI11_TEST_ENV_THREE");
+
+    // Command line, then config file, then environment, then default
+    EXPECT_EQ(1, one);
+    EXPECT_EQ(20, two);
+    EXPECT_EQ(300, three);
+    EXPECT_EQ(4, four);
+}
+
 TEST_F(TApp, IniSuccessOnUnknownOption) {
     TempFile tmpini{"TestIniTmp.ini"};
 
@@ -391,6 +429,29 @@ TEST_F(TApp, IniVector) {
     EXPECT_EQ(std::vector<int>({1, 2, 3}), three);
 }
 
+TEST_F(TApp, IniDelimitedVector) {
+
+    TempFile tmpini{"TestIniTmp.ini"};
+
+    app.set_config("--config", tmpini);
+
+    {
+        std::ofstream out{tmpini};
+        out << "[default]" << std::endl;
+        out << "ids=1,2,3" << std::endl;
+        out << "more=4,5 6" << std::endl;
+    }
+
+    std::vector<int> ids, more;
+    app.add_option("--ids", ids)->delimiter(',');
+    app.add_option("--more", more)->delimiter(',');
+
+    run();
+
+    EXPECT_EQ(std::vector<int>({1, 2, 3}), ids);
+    EXPECT_EQ(std::vector<int>({4, 5, 6}), more);
+}
+
 TEST_F(TApp, IniLayered) {
 
     TempFile tmpini{"TestIniTmp.ini"};
@@ -516,6 +577,26 @@ TEST_F(TApp, IniFlagConvertFailure) {
     EXPECT_THROW(run(), CLI::ConversionError);
 }
 
+TEST_F(TApp, IniFlagNumberOutOfRange) {
+
+    TempFile tmpini{"TestIniTmp.ini"};
+
+    app.add_flag("--flag");
+    app.set_config("--config", tmpini);
+
+    {
+        std::ofstream out{tmpini};
+        out << "flag=99999999999999999999999" << std::endl;
+    }
+
+    std::vector<std::string> input;
+    CLI::ParseStatus status = app.try_parse(input);
+    EXPECT_EQ(CLI::ParseStatus::Kind::ConversionTrueFalse, status.get_kind());
+
+    app.reset();
+    EXPECT_THROW(run(), CLI::ConversionError);
+}
+
 TEST_F(TApp, IniFlagNumbers) {
 
     TempFile tmpini{"TestIniTmp.ini"};
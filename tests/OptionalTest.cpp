@@ -24,6 +24,24 @@ TEST_F(TApp, StdOptionalTest) {
     EXPECT_EQ(*opt, 3);
 }
 
+TEST_F(TApp, StdOptionalParser) {
+    std::optional<int> opt;
+    std::optional<std::string> name;
+    app.add_option("-c,--count", opt);
+    app.add_option("--name", name);
+
+    args = {"-c", "0x10", "--name", "two words"};
+    run();
+    EXPECT_EQ(*opt, 16);
+    EXPECT_EQ(*name, "two words");
+
+    app.reset();
+    opt.reset();
+    args = {"-c", "1x"};
+    EXPECT_THROW(run(), CLI::ConversionError);
+    EXPECT_FALSE(opt);
+}
+
 #endif
 #ifdef CLI11_EXPERIMENTAL_OPTIONAL
 
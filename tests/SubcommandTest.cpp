@@ -263,6 +263,20 @@ TEST_F(TApp, FallThroughShort) {
     run();
 }
 
+TEST_F(TApp, FallThroughShortCluster) {
+    app.fallthrough();
+    int top = 0, low = 0;
+    app.add_flag("-t", top);
+
+    auto sub = app.add_subcommand("sub");
+    sub->add_flag("-l", low);
+
+    args = {"sub", "-ltlt"};
+    run();
+    EXPECT_EQ(2, top);
+    EXPECT_EQ(2, low);
+}
+
 TEST_F(TApp, FallThroughPositional) {
     app.fallthrough();
     int val = 1;
@@ -395,6 +409,28 @@ TEST_F(TApp, BadSubcomSearch) {
     EXPECT_THROW(app.get_subcommand(two), CLI::OptionNotFound);
 }
 
+TEST_F(TApp, SubcomFromParentLevels) {
+    auto sub1 = app.add_subcommand("sub1");
+    auto inner = sub1->add_subcommand("inner");
+    auto sub2 = app.add_subcommand("sub2");
+
+    args = {"sub1", "inner", "sub2"};
+    run();
+    EXPECT_EQ(std::vector<CLI::App *>({sub1, sub2}), app.get_subcommands());
+    EXPECT_EQ(std::vector<CLI::App *>({inner}), sub1->get_subcommands());
+
+    // An already parsed subcommand is not matched again at any level
+    app.reset();
+    args = {"sub1", "inner", "sub1"};
+    EXPECT_THROW(run(), CLI::ExtrasError);
+
+    // A level that reached its maximum is skipped
+    app.reset();
+    app.require_subcommand(0, 1);
+    args = {"sub1", "inner", "sub2"};
+    EXPECT_THROW(run(), CLI::ExtrasError);
+}
+
 TEST_F(TApp, PrefixProgram) {
 
     app.prefix_command();